@@ -0,0 +1,437 @@
+// async_log.c
+//===========================
+// Per-thread SPSC rings + one background writer thread.
+// Producer = the logging thread (only writes 'head' of its own ring).
+// Consumer = the writer thread (only writes 'tail' of every ring).
+//===========================
+
+#define _GNU_SOURCE
+#include "async_log.h"
+#include <errno.h>
+#include <inttypes.h>  // for PRIu64
+#include <pthread.h>
+#include <sched.h>     // for sched_yield
+#include <stdatomic.h>
+#include <stdio.h>     // for snprintf
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/uio.h>   // for writev
+
+#define ALOG_RING_MASK (ALOG_RING_CAPACITY - 1)
+#define ALOG_CHUNK_SIZE 4096       // bytes of formatted text per iovec entry
+#define ALOG_IOV_COUNT 16          // iovec entries per writev -> up to 64 KB per syscall
+#define ALOG_MAX_LINE 256          // longest formatted record
+#define ALOG_IDLE_SLEEP_NS 1000000 // writer sleeps 1 ms when every ring is empty
+#define ALOG_WRITER_EXITED UINT64_MAX // flush_done value once the writer has exited
+
+_Static_assert((ALOG_RING_CAPACITY & ALOG_RING_MASK) == 0, "ALOG_RING_CAPACITY must be a power of two");
+_Static_assert(sizeof(alog_record_t) == 64, "alog_record_t should fill exactly one cache line");
+
+//============================ alog_ring_t ================================
+// Private: one ring per logging thread. head and tail on separate cache lines.
+// When its thread exits the ring is released and the next new thread takes it
+// over; records the old owner left are still drained first (same head/tail).
+typedef struct {
+    _Alignas(64) _Atomic uint32_t head;   // written by the owning thread
+    _Atomic uint64_t dropped;             // written by the owning thread, read by the writer
+    _Atomic bool owned;                   // a live thread is using this ring
+    _Atomic bool busy;                    // owner is inside push() (alog_stop waits for it)
+    _Alignas(64) _Atomic uint32_t tail;   // written by the writer thread
+    alog_record_t records[ALOG_RING_CAPACITY];
+} alog_ring_t;
+
+//========================================
+// Static variables (private to this file)
+//========================================
+static _Atomic(alog_ring_t*) rings[ALOG_MAX_THREADS]; // registered rings (allocated on first log)
+static _Atomic size_t ring_count = 0;               // number of slots handed out
+static _Atomic uint64_t dropped_no_ring = 0;        // records from threads that found no free ring
+static _Thread_local alog_ring_t* my_ring = NULL;   // this thread's ring
+static pthread_key_t ring_key;                      // its destructor releases the ring at thread exit
+static pthread_once_t ring_key_once = PTHREAD_ONCE_INIT;
+
+static pthread_t writer_thread;
+static _Atomic bool running = false;
+static _Atomic bool stop_requested = false;
+static _Atomic uint64_t flush_requested = 0;        // bumped by alog_flush
+static _Atomic uint64_t flush_done = 0;             // set by the writer when a flush is complete
+static bool atexit_registered = false;
+static int out_fd = 1;
+
+// Writer-only state: the batch being formatted
+static char chunks[ALOG_IOV_COUNT][ALOG_CHUNK_SIZE];
+static struct iovec iov[ALOG_IOV_COUNT];
+static int iov_used = 0;          // chunks started
+static uint64_t reported_drops = 0;
+
+//========================= get_ring =================================
+// Thread exit: hand the ring back. Release: the next owner must see our last head.
+static void release_ring(void* ring) {
+    atomic_store_explicit(&((alog_ring_t*)ring)->owned, false, memory_order_release);
+}
+
+static void make_ring_key(void) {
+    pthread_key_create(&ring_key, release_ring);
+}
+
+/*
+Return this thread's ring, registering one on first use.
+Rings come from a fixed pool so memory stays bounded: first a ring released by
+a thread that exited, otherwise a new one while fewer than ALOG_MAX_THREADS exist.
+A thread that finds none free drops its records (counted) instead of blocking,
+and tries again on its next record.
+*/
+static alog_ring_t* get_ring(void) {
+    if (my_ring != NULL) return my_ring;
+    pthread_once(&ring_key_once, make_ring_key);
+
+    alog_ring_t* ring = NULL;
+    size_t count = atomic_load(&ring_count);
+    if (count > ALOG_MAX_THREADS) count = ALOG_MAX_THREADS;
+    for (size_t i = 0; (i < count) && (ring == NULL); i++) {
+        alog_ring_t* r = atomic_load_explicit(&rings[i], memory_order_acquire);
+        bool expected = false;
+        if ((r != NULL) && atomic_compare_exchange_strong(&r->owned, &expected, true)) ring = r;
+    }
+
+    if ((ring == NULL) && (count < ALOG_MAX_THREADS)) {
+        // Allocate before taking a slot, so a failed allocation does not use one up
+        alog_ring_t* r = aligned_alloc(64, sizeof(alog_ring_t));
+        if (r == NULL) return NULL;
+        atomic_init(&r->head, 0);
+        atomic_init(&r->tail, 0);
+        atomic_init(&r->dropped, 0);
+        atomic_init(&r->owned, true);
+        atomic_init(&r->busy, false);
+
+        size_t slot = atomic_fetch_add(&ring_count, 1);
+        if (slot >= ALOG_MAX_THREADS) {
+            atomic_fetch_sub(&ring_count, 1);
+            free(r);
+            return NULL;
+        }
+        // Release: the writer must see an initialized ring once it sees the pointer
+        atomic_store_explicit(&rings[slot], r, memory_order_release);
+        ring = r;
+    }
+    if (ring == NULL) return NULL;
+
+    pthread_setspecific(ring_key, ring);
+    my_ring = ring;
+    return ring;
+}
+
+//========================= push =================================
+// The ring part of push(): only the owning thread gets here
+static alog_error_t push_to_ring(alog_ring_t* ring, const alog_record_t* rec) {
+    uint32_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+    if (head - tail >= ALOG_RING_CAPACITY) {
+        // only this thread writes 'dropped', a plain load + store is enough
+        uint64_t d = atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+        atomic_store_explicit(&ring->dropped, d + 1, memory_order_relaxed);
+        return ALOG_ERROR_FULL;
+    }
+
+    ring->records[head & ALOG_RING_MASK] = *rec;
+    atomic_store_explicit(&ring->head, head + 1, memory_order_release);
+    return ALOG_SUCCESS;
+}
+
+// Copy one record into this thread's ring. Never blocks: full ring -> drop.
+static alog_error_t push(const alog_record_t* rec) {
+    if (!atomic_load_explicit(&running, memory_order_relaxed)) return ALOG_ERROR_STOPPED;
+
+    alog_ring_t* ring = get_ring();
+    if (ring == NULL) {
+        atomic_fetch_add_explicit(&dropped_no_ring, 1, memory_order_relaxed);
+        return ALOG_ERROR_THREADS;
+    }
+
+    /*
+    Announce the push, then check 'running' again. Both are seq_cst, like the
+    'running' store and 'busy' loads in alog_stop(): either this thread sees the
+    stop and backs out, or alog_stop() sees 'busy' and waits for the record
+    before the writer's last drain. The flag is on the owner's cache line, so
+    threads do not contend on it.
+    */
+    atomic_store(&ring->busy, true);
+    if (!atomic_load(&running)) {
+        atomic_store_explicit(&ring->busy, false, memory_order_release);
+        return ALOG_ERROR_STOPPED;
+    }
+    alog_error_t result = push_to_ring(ring, rec);
+    atomic_store_explicit(&ring->busy, false, memory_order_release);
+    return result;
+}
+
+//========================= batch output (writer thread) =================================
+
+// writev everything formatted so far, retrying on partial writes
+static void write_batch(void) {
+    int first = 0;
+    while (first < iov_used) {
+        ssize_t n = writev(out_fd, &iov[first], iov_used - first);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break; // output is broken, nothing useful we can do: drop the batch
+        }
+        // Skip fully written entries, adjust a partially written one
+        while ((first < iov_used) && ((size_t)n >= iov[first].iov_len)) {
+            n -= (ssize_t)iov[first].iov_len;
+            first++;
+        }
+        if (first < iov_used) {
+            iov[first].iov_base = (char*)iov[first].iov_base + n;
+            iov[first].iov_len -= (size_t)n;
+        }
+    }
+    iov_used = 0;
+}
+
+// Reserve room for one line; flushes the batch when all chunks are full
+static char* line_start(void) {
+    if ((iov_used == 0) || (ALOG_CHUNK_SIZE - iov[iov_used - 1].iov_len < ALOG_MAX_LINE)) {
+        if (iov_used == ALOG_IOV_COUNT) write_batch();
+        iov[iov_used].iov_base = chunks[iov_used];
+        iov[iov_used].iov_len = 0;
+        iov_used++;
+    }
+    return (char*)iov[iov_used - 1].iov_base + iov[iov_used - 1].iov_len;
+}
+
+static void line_end(int written) {
+    if (written > 0) {
+        iov[iov_used - 1].iov_len += (written < ALOG_MAX_LINE) ? (size_t)written : ALOG_MAX_LINE - 1;
+    }
+}
+
+// Same text as the original printf calls in each module
+static void format_record(const alog_record_t* r) {
+    char* p = line_start();
+    const sensor_data_t* d = &r->u.reading;
+    int n = 0;
+
+    switch (r->type) {
+        case ALOG_REC_TEXT:
+            n = snprintf(p, ALOG_MAX_LINE, "%s", r->u.text);
+            break;
+        case ALOG_REC_SENSOR:
+            n = snprintf(p, ALOG_MAX_LINE,
+                         "=== Sensor Reading ===\nSensor ID: %u\nTimestamp: %u us\nTemperature: %.2f C\n"
+                         "Humidity: %.2f %%\nStatus: 0x%02X\n======================\n",
+                         d->sensor_id, d->timestamp, d->temperature, d->humidity, d->status);
+            break;
+        case ALOG_REC_CB_ENTRY:
+            n = snprintf(p, ALOG_MAX_LINE,
+                         "Index %u = Temperature: %.2f | Humidity: %.2f%% | Sensor ID: %u | Status: %u | Timestamp: %u\n",
+                         r->index, d->temperature, d->humidity, d->sensor_id, d->status, d->timestamp);
+            break;
+        case ALOG_REC_NODE:
+            n = snprintf(p, ALOG_MAX_LINE,
+                         "Timestamp=%u | Temperature=%.2f | Humidity=%.2f%% | SensorID=%u | Status=%u\n",
+                         d->timestamp, d->temperature, d->humidity, d->sensor_id, d->status);
+            break;
+        case ALOG_REC_LEAK:
+            n = snprintf(p, ALOG_MAX_LINE, "Location: %p\nName: %s\nSize: %zu\nTimestamp: %" PRIu64 " ns\n",
+                         r->u.leak.ptr, r->u.leak.name, r->u.leak.size, r->u.leak.timestamp);
+            break;
+        case ALOG_REC_LEAK_TOTAL:
+            n = snprintf(p, ALOG_MAX_LINE, "Total leaks: %zu, Total bytes: %zu\n", r->u.total.count, r->u.total.bytes);
+            break;
+        default:
+            break;
+    }
+    line_end(n);
+}
+
+//========================= drain_all (writer thread) =================================
+// Move everything currently queued into the batch. Returns the number of records.
+static size_t drain_all(void) {
+    size_t total = 0;
+    size_t count = atomic_load(&ring_count);
+    if (count > ALOG_MAX_THREADS) count = ALOG_MAX_THREADS;
+
+    for (size_t i = 0; i < count; i++) {
+        alog_ring_t* ring = atomic_load_explicit(&rings[i], memory_order_acquire);
+        if (ring == NULL) continue; // slot handed out, ring not published yet
+
+        uint32_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+        uint32_t head = atomic_load_explicit(&ring->head, memory_order_acquire);
+        for (; tail != head; tail++) {
+            format_record(&ring->records[tail & ALOG_RING_MASK]);
+            total++;
+        }
+        // Release: slots are formatted before the producer may reuse them
+        atomic_store_explicit(&ring->tail, tail, memory_order_release);
+    }
+
+    // Report new drops in the output itself so they are not silent
+    uint64_t drops = alog_dropped();
+    if (drops != reported_drops) {
+        int n = snprintf(line_start(), ALOG_MAX_LINE, "[async_log] %" PRIu64 " records dropped so far\n", drops);
+        line_end(n);
+        reported_drops = drops;
+    }
+
+    if (iov_used > 0) write_batch();
+    return total;
+}
+
+//========================= writer_main =================================
+static void* writer_main(void* arg) {
+    (void)arg;
+    struct timespec idle = { 0, ALOG_IDLE_SLEEP_NS };
+
+    while (true) {
+        uint64_t flush_id = atomic_load(&flush_requested);
+        bool stopping = atomic_load(&stop_requested);
+
+        size_t n = drain_all();
+
+        // This pass started after request 'flush_id', so everything pushed
+        // before that request has been written now
+        atomic_store(&flush_done, flush_id);
+
+        if (n == 0) {
+            if (stopping) break; // stop request seen and nothing left
+            nanosleep(&idle, NULL);
+        }
+    }
+    // A flush requested after our last pass read flush_requested would wait for ever
+    atomic_store(&flush_done, ALOG_WRITER_EXITED);
+    return NULL;
+}
+
+//================================ alog_start =================================
+alog_error_t alog_start(int fd) {
+    if (atomic_load(&running)) return ALOG_SUCCESS;
+
+    out_fd = fd;
+    atomic_store(&stop_requested, false);
+    atomic_store(&flush_done, atomic_load(&flush_requested)); // clear ALOG_WRITER_EXITED of a previous run
+    if (pthread_create(&writer_thread, NULL, writer_main, NULL) != 0) {
+        return ALOG_ERROR_SYSTEM;
+    }
+    atomic_store(&running, true);
+
+    if (!atexit_registered) {
+        atexit(alog_stop); // flush-on-exit
+        atexit_registered = true;
+    }
+    return ALOG_SUCCESS;
+}
+
+//================================ alog_stop =================================
+// Wait until no producer is between its 'running' check and its head update
+static void wait_for_producers(void) {
+    size_t count = atomic_load(&ring_count);
+    if (count > ALOG_MAX_THREADS) count = ALOG_MAX_THREADS;
+
+    for (size_t i = 0; i < count; i++) {
+        alog_ring_t* ring;
+        // A taken slot is published right after it is taken
+        while ((ring = atomic_load_explicit(&rings[i], memory_order_acquire)) == NULL) sched_yield();
+        while (atomic_load(&ring->busy)) sched_yield();
+    }
+}
+
+void alog_stop(void) {
+    if (!atomic_load(&running)) return;
+
+    atomic_store(&running, false);       // new records are refused from here on
+    wait_for_producers();                // records already being pushed land before the last drain
+    atomic_store(&stop_requested, true); // writer drains what is left, then exits
+    pthread_join(writer_thread, NULL);
+}
+
+bool alog_is_running(void) {
+    return atomic_load_explicit(&running, memory_order_relaxed);
+}
+
+//================================ alog_flush =================================
+// Ask the writer for a flush and wait until it reports a pass after the request,
+// or until it exits (alog_stop() between the 'running' check and the request)
+alog_error_t alog_flush(void) {
+    if (!atomic_load(&running)) return ALOG_ERROR_STOPPED;
+
+    uint64_t id = atomic_fetch_add(&flush_requested, 1) + 1;
+    struct timespec pause = { 0, 50000 }; // 50 us
+    uint64_t done;
+    while ((done = atomic_load(&flush_done)) < id) {
+        nanosleep(&pause, NULL);
+    }
+    return (done == ALOG_WRITER_EXITED) ? ALOG_ERROR_STOPPED : ALOG_SUCCESS;
+}
+
+//================================ alog_dropped =================================
+uint64_t alog_dropped(void) {
+    uint64_t total = atomic_load_explicit(&dropped_no_ring, memory_order_relaxed);
+    size_t count = atomic_load(&ring_count);
+    if (count > ALOG_MAX_THREADS) count = ALOG_MAX_THREADS;
+
+    for (size_t i = 0; i < count; i++) {
+        alog_ring_t* ring = atomic_load_explicit(&rings[i], memory_order_acquire);
+        if (ring != NULL) total += atomic_load_explicit(&ring->dropped, memory_order_relaxed);
+    }
+    return total;
+}
+
+//================================ record producers =================================
+
+alog_error_t alog_text(const char* text) {
+    if (text == NULL) return ALOG_ERROR_NULL;
+    alog_record_t rec;
+    rec.type = ALOG_REC_TEXT;
+    strncpy(rec.u.text, text, ALOG_TEXT_MAX - 1);
+    rec.u.text[ALOG_TEXT_MAX - 1] = '\0';
+    return push(&rec);
+}
+
+alog_error_t alog_sensor(const sensor_data_t* data) {
+    if (data == NULL) return ALOG_ERROR_NULL;
+    alog_record_t rec;
+    rec.type = ALOG_REC_SENSOR;
+    rec.u.reading = *data;
+    return push(&rec);
+}
+
+alog_error_t alog_cb_entry(size_t index, const sensor_data_t* data) {
+    if (data == NULL) return ALOG_ERROR_NULL;
+    alog_record_t rec;
+    rec.type = ALOG_REC_CB_ENTRY;
+    rec.index = (uint32_t)index;
+    rec.u.reading = *data;
+    return push(&rec);
+}
+
+alog_error_t alog_node(uint32_t timestamp, float temperature, float humidity, uint8_t sensor_id, uint8_t status) {
+    alog_record_t rec;
+    rec.type = ALOG_REC_NODE;
+    rec.u.reading.timestamp = timestamp;
+    rec.u.reading.temperature = temperature;
+    rec.u.reading.humidity = humidity;
+    rec.u.reading.sensor_id = sensor_id;
+    rec.u.reading.status = status;
+    return push(&rec);
+}
+
+alog_error_t alog_leak(const void* ptr, const char* name, size_t size, uint64_t timestamp_ns) {
+    alog_record_t rec;
+    rec.type = ALOG_REC_LEAK;
+    rec.u.leak.ptr = ptr;
+    rec.u.leak.name = name;
+    rec.u.leak.size = size;
+    rec.u.leak.timestamp = timestamp_ns;
+    return push(&rec);
+}
+
+alog_error_t alog_leak_total(size_t count, size_t bytes) {
+    alog_record_t rec;
+    rec.type = ALOG_REC_LEAK_TOTAL;
+    rec.u.total.count = count;
+    rec.u.total.bytes = bytes;
+    return push(&rec);
+}
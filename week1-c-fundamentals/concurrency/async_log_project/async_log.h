@@ -0,0 +1,89 @@
+// async_log.h
+//===========================
+// Asynchronous batched log writer.
+// Callers push small binary records into a lock-free ring owned by their
+// thread (no formatting, no syscall, no lock). A background writer thread
+// drains all rings, formats the records in batches and writes them with
+// large writev() calls.
+//
+// The print functions of sensor_data, circular_buffer, linked_list and
+// memory_tools route through it when compiled with -DUSE_ASYNC_LOG and the
+// writer is running; otherwise they keep using printf.
+//===========================
+
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "../../data_structures/sensor_data_project/sensor_data.h"
+
+#define ALOG_RING_CAPACITY 4096  // records per thread, power of two (4096 * 64 B = 256 KB)
+#define ALOG_MAX_THREADS 8       // threads that can log at the same time; bounds total memory to 2 MB
+#define ALOG_TEXT_MAX 48         // max text record length, including the '\0'
+
+//================================= Error Codes ==============================//
+typedef enum {
+    ALOG_SUCCESS,         // Operation succeeded
+    ALOG_ERROR_FULL,      // Ring full, record dropped (counted in alog_dropped)
+    ALOG_ERROR_NULL,      // Provided pointer is NULL
+    ALOG_ERROR_STOPPED,   // Writer is not running
+    ALOG_ERROR_THREADS,   // More than ALOG_MAX_THREADS live threads tried to log
+    ALOG_ERROR_SYSTEM     // Thread creation or memory allocation failed
+} alog_error_t;
+
+//================================= Record Layout ==============================//
+// Which format the writer uses for a record (one per existing print function)
+typedef enum {
+    ALOG_REC_TEXT,        // fixed text line
+    ALOG_REC_SENSOR,      // print_sensor_data block
+    ALOG_REC_CB_ENTRY,    // one line of cb_print_all
+    ALOG_REC_NODE,        // one line of print_all_readings / find_specific_reading
+    ALOG_REC_LEAK,        // one leak of report_leaks
+    ALOG_REC_LEAK_TOTAL   // summary line of report_leaks
+} alog_record_type_t;
+
+/*
+One record = 64 bytes = one cache line (aligned and padded to it, so no record
+straddles two lines). Only raw values are copied on the caller's thread;
+turning them into text is the writer's job.
+*/
+typedef struct {
+    _Alignas(64) uint8_t type; // alog_record_type_t
+    uint32_t index;         // CB_ENTRY: buffer index
+    union {
+        sensor_data_t reading;                                              // SENSOR, CB_ENTRY, NODE
+        struct { const void* ptr; const char* name; size_t size; uint64_t timestamp; } leak; // LEAK
+        struct { size_t count; size_t bytes; } total;                      // LEAK_TOTAL
+        char text[ALOG_TEXT_MAX];                                          // TEXT
+    } u;
+} alog_record_t;
+
+//================================= Function Prototypes =======================//
+// Start the writer thread, writing to 'fd' (e.g. 1 for stdout).
+// Registers alog_stop() with atexit() so nothing is lost on normal exit.
+alog_error_t alog_start(int fd);
+
+// Write everything still queued, then stop the writer thread
+void alog_stop(void);
+
+// True while the writer is running (print functions check this)
+bool alog_is_running(void);
+
+// Block until every record pushed before this call has been written.
+// ALOG_ERROR_STOPPED if the writer is not running or stops while waiting.
+alog_error_t alog_flush(void);
+
+// Records lost because a ring was full or too many threads were logging
+uint64_t alog_dropped(void);
+
+// Record producers: O(1), never block
+alog_error_t alog_text(const char* text);       // copies at most ALOG_TEXT_MAX - 1 chars
+alog_error_t alog_sensor(const sensor_data_t* data);
+alog_error_t alog_cb_entry(size_t index, const sensor_data_t* data);
+alog_error_t alog_node(uint32_t timestamp, float temperature, float humidity, uint8_t sensor_id, uint8_t status);
+alog_error_t alog_leak(const void* ptr, const char* name, size_t size, uint64_t timestamp_ns); // 'name' must outlive the record
+alog_error_t alog_leak_total(size_t count, size_t bytes);
+
+#endif // ASYNC_LOG_H
@@ -0,0 +1,158 @@
+// Build with -DUSE_ASYNC_LOG so the print functions can route through the writer
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "async_log.h"
+#include "../../timing/mono_clock_project/mono_clock.h"
+#include "../../data_structures/circular_buffer_project/circular_buffer.h"
+#include "../../data_structures/linked_list_project/linked_list.h"
+#include "../../memory_management/dynamic_memory_project/memory_tools.h"
+
+#define BENCH_CALLS 50000          // print_sensor_data calls per run
+#define BENCH_GAP_NS 5000          // one reading every 5 us (200k readings/s)
+#define SINK_READ_BYTES 32768      // slow output: read 32 KB ...
+#define SINK_PAUSE_US 1000         // ... then pause 1 ms (~32 MB/s, with stalls)
+
+
+static int sink_fd = -1;
+static _Atomic bool sink_running = false; // read by the sink thread, cleared by main
+
+// Slow consumer of the output, like a terminal or a log shipper that falls behind
+static void* sink_main(void* arg){
+    (void)arg;
+    static char buf[SINK_READ_BYTES];
+    while(atomic_load(&sink_running)){
+        if(read(sink_fd, buf, sizeof(buf)) <= 0) break;
+        usleep(SINK_PAUSE_US);
+    }
+    return NULL;
+}
+
+// Used by qsort to sort latency samples
+static int compare_u64(const void* a, const void* b){
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Call print_sensor_data at a steady rate and record how long each call blocks the caller
+static void run_calls(uint64_t* samples){
+    sensor_data_t reading = create_sensor_data(23.5, 45.0, 1);
+    uint64_t next = clk_now_ns();
+
+    for(size_t i = 0; i < BENCH_CALLS; i++){
+        while(clk_now_ns() < next){ } // wait for the next "acquisition"
+        next += BENCH_GAP_NS;
+
+        uint64_t start = clk_now_ns();
+        print_sensor_data(&reading);
+        samples[i] = clk_now_ns() - start;
+    }
+}
+
+static void print_latency(const char* label, uint64_t* samples){
+    qsort(samples, BENCH_CALLS, sizeof(uint64_t), compare_u64);
+    printf("  %-6s caller latency ns: p50=%llu p99=%llu p99.9=%llu max=%llu\n", label,
+           (unsigned long long)samples[BENCH_CALLS / 2],
+           (unsigned long long)samples[BENCH_CALLS * 99 / 100],
+           (unsigned long long)samples[BENCH_CALLS * 999 / 1000],
+           (unsigned long long)samples[BENCH_CALLS - 1]);
+}
+
+// Sync printf vs async writer, both writing to a slow pipe placed on stdout
+static void benchmark(void){
+    uint64_t* sync_samples = malloc(BENCH_CALLS * sizeof(uint64_t));
+    uint64_t* async_samples = malloc(BENCH_CALLS * sizeof(uint64_t));
+    int fds[2];
+    if((sync_samples == NULL) || (async_samples == NULL) || (pipe(fds) != 0)){
+        printf("Error: benchmark setup failed\n");
+        free(sync_samples);
+        free(async_samples);
+        return;
+    }
+
+    fflush(stdout);
+    int saved_stdout = dup(1);
+    dup2(fds[1], 1);                  // stdout -> pipe
+    sink_fd = fds[0];
+    atomic_store(&sink_running, true);
+    pthread_t sink;
+    pthread_create(&sink, NULL, sink_main, NULL);
+
+    run_calls(sync_samples);          // writer not running: plain printf
+    fflush(stdout);
+
+    alog_start(1);
+    run_calls(async_samples);         // same calls, now queued
+    uint64_t flush_start = clk_now_ns();
+    alog_flush();
+    uint64_t flush_ns = clk_now_ns() - flush_start;
+    uint64_t dropped = alog_dropped();
+    alog_stop();
+
+    // Restore stdout, then stop the sink
+    fflush(stdout);
+    dup2(saved_stdout, 1);
+    close(saved_stdout);
+    atomic_store(&sink_running, false);
+    close(fds[1]);
+    pthread_join(sink, NULL);
+    close(fds[0]);
+
+    printf("Benchmark: %d print_sensor_data calls at one per %d ns, slow pipe on stdout\n", BENCH_CALLS, BENCH_GAP_NS);
+    print_latency("sync", sync_samples);
+    print_latency("async", async_samples);
+    printf("  async: final flush %.2f ms, %llu records dropped (ring %d per thread)\n",
+           flush_ns / 1e6, (unsigned long long)dropped, ALOG_RING_CAPACITY);
+
+    free(sync_samples);
+    free(async_samples);
+}
+
+
+int main()
+{
+    clk_init(CLK_BACKEND_TSC); // cheaper timestamps for the latency samples; falls back if unavailable
+
+    //============================== Routing demo ==============================
+    printf("Async log routing demo:\n\n");
+    fflush(stdout); // anything printed with printf must be flushed before the writer starts
+
+    alog_start(1);
+
+    circular_buffer_t cb;
+    cb_init(&cb);
+    cb_print_all(&cb);                        // -> text record
+    sensor_data_t r1 = create_sensor_data(25.5, 40, 1);
+    sensor_data_t r2 = create_sensor_data(27.6, 45, 1);
+    cb_enqueue(&cb, &r1);
+    cb_enqueue(&cb, &r2);
+    cb_print_all(&cb);                        // -> one record per item
+
+    node* list = NULL;
+    add_sensor_reading(&list, 22.5, 50.0, 2);
+    add_sensor_reading(&list, 23.0, 55.0, 2);
+    print_all_readings(&list);                // -> one record per node
+    find_specific_reading(&list, list->timestamp);
+    clear_all_readings(&list);
+
+    sensor_data_t* p = safe_malloc(sizeof(sensor_data_t), "Sensor Readings");
+    *p = create_sensor_data(19.8, 60.5, 3);
+    print_sensor_data(p);                     // -> sensor record
+    report_leaks();                           // -> leak + total records (1 leak: p not freed yet)
+    safe_free(p);
+
+    alog_text("--- end of routing demo ---\n");
+    alog_flush();                             // everything above is written now
+    alog_stop();
+    printf("------------------------------------------------------------\n");
+
+    //============================== Benchmark ==============================
+    benchmark();
+    printf("------------------------------------------------------------\n");
+
+    return 0;
+}
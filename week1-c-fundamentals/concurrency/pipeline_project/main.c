@@ -0,0 +1,243 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include "pipeline.h"
+#include "../../timing/mono_clock_project/mono_clock.h"
+#include "../../data_structures/window_aggregator_project/window_aggregator.h"
+
+#define BENCH_READINGS (1u << 21)   // ~2M readings per run
+#define SENSOR_COUNT 16             // ids 0..15, within AGG_MAX_CHANNELS per shard
+#define AGG_WINDOW 64
+
+// Demo-only status bit, not part of sensor_data.h: air close to its dew point
+#define STATUS_CONDENSATION_RISK 0x20
+
+
+//============================== Stages ==============================
+
+// Per-sensor calibration, shared read-only by all workers
+typedef struct {
+    float temp_gain[256], temp_offset[256];
+    float hum_offset[256];
+} calibration_t;
+
+/*
+Process stage (stateless): apply calibration, check ranges, and flag
+condensation risk from the dew point (Magnus formula). Depends only on the
+reading and read-only tables, so any worker can run any batch.
+*/
+static size_t process_readings(sensor_data_t* readings, size_t count, void* ctx){
+    const calibration_t* cal = ctx;
+
+    for(size_t i = 0; i < count; i++){
+        sensor_data_t* r = &readings[i];
+        float t = r->temperature * cal->temp_gain[r->sensor_id] + cal->temp_offset[r->sensor_id];
+        float h = r->humidity + cal->hum_offset[r->sensor_id];
+        uint8_t status = r->status & (uint8_t)~SENSOR_STATUS_UNCALIBRATED;
+
+        if((t < -40.0f) || (t > 85.0f)) status |= SENSOR_STATUS_TEMP_FAULT;
+        if((h <= 0.0f) || (h > 100.0f)) status |= SENSOR_STATUS_HUM_FAULT;
+        else {
+            float gamma = logf(h / 100.0f) + (17.62f * t) / (243.12f + t);
+            float dew_point = 243.12f * gamma / (17.62f - gamma);
+            if(t - dew_point < 2.0f) status |= STATUS_CONDENSATION_RISK;
+        }
+
+        r->temperature = t;
+        r->humidity = h;
+        r->status = status;
+    }
+    return count;
+}
+
+// Emit stage state, one per shard (own cache lines, touched by one thread only)
+typedef struct {
+    _Alignas(64) circular_buffer_t cb;
+    window_aggregator_t agg;          // tumbling per-sensor stats: needs readings in order
+    uint32_t last_ts[256];            // ordering check
+    uint64_t emitted;
+    uint64_t out_of_order;
+    uint64_t condensation;
+} shard_state_t;
+
+static shard_state_t shard_states[PIPE_MAX_SHARDS];
+
+static void reset_shard_states(size_t shards){
+    for(size_t s = 0; s < shards; s++){
+        shard_state_t* st = &shard_states[s];
+        cb_init(&st->cb);
+        agg_attach(&st->agg, &st->cb, AGG_MODE_TUMBLING, AGG_WINDOW);
+        memset(st->last_ts, 0, sizeof(st->last_ts));
+        st->emitted = st->out_of_order = st->condensation = 0;
+    }
+}
+
+// Emit stage (stateful, per shard): ordering check + window aggregator
+static void emit_readings(size_t shard, const sensor_data_t* readings, size_t count, void* ctx){
+    shard_state_t* st = &((shard_state_t*)ctx)[shard];
+
+    for(size_t i = 0; i < count; i++){
+        const sensor_data_t* r = &readings[i];
+        if(r->timestamp <= st->last_ts[r->sensor_id]) st->out_of_order++;
+        st->last_ts[r->sensor_id] = r->timestamp;
+        if(r->status & STATUS_CONDENSATION_RISK) st->condensation++;
+        agg_enqueue_force(&st->agg, r);
+    }
+    st->emitted += count;
+}
+
+//============================== Ingest ==============================
+
+// Small fast random generator (xorshift)
+static uint32_t rng_state = 2463534242u;
+static uint32_t next_random(void){
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// Create reading number 'i'. The timestamp is the reading number, so the
+// emit stage can check per-sensor ordering exactly.
+static void make_reading(sensor_data_t* r, uint32_t i){
+    uint32_t x = next_random();
+    r->timestamp = i + 1;
+    r->temperature = 15.0f + (float)(x % 2000) / 100.0f;   // 15 .. 35 C
+    r->humidity = 30.0f + (float)((x >> 11) % 6900) / 100.0f; // 30 .. 99 %
+    r->sensor_id = (uint8_t)((x >> 24) % SENSOR_COUNT);
+    r->status = SENSOR_STATUS_UNCALIBRATED;
+}
+
+static void init_calibration(calibration_t* cal){
+    for(size_t id = 0; id < 256; id++){
+        cal->temp_gain[id] = 1.0f + (float)(id % 5) * 0.001f;
+        cal->temp_offset[id] = -0.2f + (float)(id % 7) * 0.05f;
+        cal->hum_offset[id] = (float)(id % 3) - 1.0f;
+    }
+}
+
+//============================== Benchmark ==============================
+
+// All stages on one thread, as main() used to do it
+static double run_single_thread(calibration_t* cal){
+    sensor_data_t batch[PIPE_BATCH_SIZE];
+    reset_shard_states(1);
+    rng_state = 2463534242u;
+
+    uint64_t start = clk_now_ns();
+    for(uint32_t i = 0; i < BENCH_READINGS; i += PIPE_BATCH_SIZE){
+        for(uint32_t k = 0; k < PIPE_BATCH_SIZE; k++) make_reading(&batch[k], i + k);
+        size_t n = process_readings(batch, PIPE_BATCH_SIZE, cal);
+        emit_readings(0, batch, n, shard_states);
+    }
+    double seconds = (double)(clk_now_ns() - start) / 1e9;
+    return BENCH_READINGS / seconds;
+}
+
+// One shard per two workers, so the emit stage does not cap the scaling
+static size_t shards_for(size_t workers){
+    size_t shards = (workers + 1) / 2;
+    return (shards > PIPE_MAX_SHARDS) ? PIPE_MAX_SHARDS : shards;
+}
+
+static double run_pipeline(pipeline_t* p, calibration_t* cal, size_t workers, double baseline){
+    size_t shards = shards_for(workers);
+    pipe_config_t config = {
+        .worker_count = workers,
+        .shard_count = shards,
+        .process = process_readings,
+        .process_ctx = cal,
+        .emit = emit_readings,
+        .emit_ctx = shard_states,
+    };
+    reset_shard_states(shards);
+    rng_state = 2463534242u;
+
+    pipe_error_t err = pipe_start(p, &config);
+    if(err != PIPE_SUCCESS){
+        printf("Error starting pipeline, error code: %d\n", err);
+        return 0.0;
+    }
+
+    uint64_t start = clk_now_ns();
+    for(uint32_t i = 0; i < BENCH_READINGS; i += PIPE_BATCH_SIZE){
+        sensor_data_t* batch = pipe_acquire(p);   // zero-copy: create readings in place
+        for(uint32_t k = 0; k < PIPE_BATCH_SIZE; k++) make_reading(&batch[k], i + k);
+        pipe_publish(p, PIPE_BATCH_SIZE);
+    }
+    pipe_stop(p);                                 // drains first
+    double seconds = (double)(clk_now_ns() - start) / 1e9;
+    double rate = BENCH_READINGS / seconds;
+
+    uint64_t stolen = 0, emitted = 0, out_of_order = 0;
+    for(size_t w = 0; w < workers; w++) stolen += pipe_worker_stolen(p, w);
+    for(size_t s = 0; s < shards; s++){
+        emitted += shard_states[s].emitted;
+        out_of_order += shard_states[s].out_of_order;
+    }
+    printf("  %2zu workers, %zu shards: %6.2f M readings/s (%.2fx) | emitted %llu | out of order %llu | stolen batches %llu\n",
+           workers, shards, rate / 1e6, (baseline > 0.0) ? rate / baseline : 1.0,
+           (unsigned long long)emitted, (unsigned long long)out_of_order,
+           (unsigned long long)stolen);
+    return rate;
+}
+
+
+int main()
+{
+    clk_init(CLK_BACKEND_TSC);
+
+    static pipeline_t pipeline;   // static: ~350 KB
+    static calibration_t calibration;
+    init_calibration(&calibration);
+
+    //============================== Demo ==============================
+    pipe_config_t config = {
+        .worker_count = 2,
+        .shard_count = 2,
+        .process = process_readings,
+        .process_ctx = &calibration,
+        .emit = emit_readings,
+        .emit_ctx = shard_states,
+    };
+    reset_shard_states(2);
+    if(pipe_start(&pipeline, &config) != PIPE_SUCCESS){
+        printf("Error starting pipeline\n");
+        return 1;
+    }
+
+    sensor_data_t readings[1000];
+    for(uint32_t i = 0; i < 1000; i++) make_reading(&readings[i], i);
+    pipe_submit(&pipeline, readings, 1000);   // 4 batches
+    pipe_stop(&pipeline);
+
+    printf("Pipeline demo: 1000 readings, 2 workers, 2 shards (even / odd sensor ids)\n");
+    for(size_t s = 0; s < 2; s++){
+        printf("Shard %zu: %llu readings, %llu out of order, %llu with condensation risk\n", s,
+               (unsigned long long)shard_states[s].emitted,
+               (unsigned long long)shard_states[s].out_of_order,
+               (unsigned long long)shard_states[s].condensation);
+        agg_print_all(&shard_states[s].agg);
+    }
+    printf("------------------------------------------------------------\n");
+
+    //============================== Benchmark ==============================
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t max_workers = (cpus > 4) ? (size_t)cpus : 4; // go past the core count on small machines too
+    if(max_workers > PIPE_MAX_WORKERS) max_workers = PIPE_MAX_WORKERS;
+
+    printf("Throughput, %u readings, %ld online CPUs (scaling vs 1 worker in brackets):\n", BENCH_READINGS, cpus);
+    double single = run_single_thread(&calibration);
+    printf("  single thread: %6.2f M readings/s\n", single / 1e6);
+
+    double one_worker = run_pipeline(&pipeline, &calibration, 1, 0.0);
+    for(size_t workers = 2; workers <= max_workers; workers *= 2){
+        run_pipeline(&pipeline, &calibration, workers, one_worker);
+    }
+    printf("------------------------------------------------------------\n");
+
+    return 0;
+}
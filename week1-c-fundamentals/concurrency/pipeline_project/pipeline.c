@@ -0,0 +1,308 @@
+// pipeline.c
+//===========================
+// Worker pool (process stage) + shard threads (emit stage).
+// The ingest side runs on the caller's thread.
+//===========================
+
+#define _GNU_SOURCE
+#include "pipeline.h"
+#include <sched.h>    // for sched_yield
+#include <string.h>
+
+#define PIPE_INFLIGHT_MASK (PIPE_MAX_INFLIGHT - 1)
+#define PIPE_SPIN_LIMIT 128    // busy polls before yielding the CPU
+
+_Static_assert((PIPE_MAX_INFLIGHT & PIPE_INFLIGHT_MASK) == 0, "PIPE_MAX_INFLIGHT must be a power of two");
+_Static_assert(PIPE_BATCH_SIZE <= UINT16_MAX, "shard_start is 16-bit");
+
+//============================ backoff ================================
+// Waiting helper: spin briefly (the other side is usually only a few ns away),
+// then give the CPU away so oversubscribed machines still make progress
+static void backoff(unsigned* spins){
+    if(*spins < PIPE_SPIN_LIMIT){
+        (*spins)++;
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#endif
+    } else {
+        sched_yield();
+    }
+}
+
+//============================ worker queue ================================
+
+// Ingest only. Never full: at most PIPE_MAX_INFLIGHT batches exist.
+static void queue_push(pipe_queue_t* q, uint32_t seq){
+    uint64_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    atomic_store_explicit(&q->slots[head & PIPE_INFLIGHT_MASK], seq, memory_order_relaxed);
+    atomic_store_explicit(&q->head, head + 1, memory_order_release); // batch contents + slot visible
+}
+
+// Owner or thief. The slot is read before the CAS: if the CAS wins, tail was
+// still 'tail', so the producer cannot have reused that slot yet.
+static bool queue_pop(pipe_queue_t* q, uint32_t* seq){
+    uint64_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    for(;;){
+        uint64_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+        if(tail == head) return false;
+        *seq = atomic_load_explicit(&q->slots[tail & PIPE_INFLIGHT_MASK], memory_order_relaxed);
+        if(atomic_compare_exchange_weak_explicit(&q->tail, &tail, tail + 1,
+                                                 memory_order_acq_rel, memory_order_relaxed)){
+            return true;
+        }
+        // lost the race: 'tail' was reloaded by the failed CAS, try again
+    }
+}
+
+//============================ process stage ================================
+
+/*
+Stable partition of the batch by shard (counting sort on shard_of[sensor_id]).
+Stable = readings of the same sensor keep their order, which is what lets the
+shard threads promise per-sensor ordering.
+*/
+static void partition(pipeline_t* p, pipe_worker_t* w, pipe_batch_t* b){
+    size_t shards = p->config.shard_count;
+    uint16_t pos[PIPE_MAX_SHARDS + 1] = {0};
+
+    if(shards == 1){
+        b->shard_start[0] = 0;
+        b->shard_start[1] = (uint16_t)b->count;
+        return;
+    }
+
+    for(size_t i = 0; i < b->count; i++){
+        pos[p->shard_of[b->readings[i].sensor_id] + 1]++;
+    }
+    for(size_t s = 0; s < shards; s++){
+        pos[s + 1] += pos[s];
+    }
+    memcpy(b->shard_start, pos, (shards + 1) * sizeof(uint16_t));
+
+    for(size_t i = 0; i < b->count; i++){
+        w->scratch[pos[p->shard_of[b->readings[i].sensor_id]]++] = b->readings[i];
+    }
+    memcpy(b->readings, w->scratch, b->count * sizeof(sensor_data_t));
+}
+
+static void process_batch(pipeline_t* p, pipe_worker_t* w, uint32_t seq){
+    pipe_batch_t* b = &p->batches[seq & PIPE_INFLIGHT_MASK];
+
+    if(p->config.process != NULL){
+        b->count = (uint32_t)p->config.process(b->readings, b->count, p->config.process_ctx);
+    }
+    partition(p, w, b);
+    w->batches++;
+
+    atomic_store_explicit(&b->ready, seq + 1, memory_order_release); // hand over to the shards
+}
+
+// Worker thread: own queue first, then steal from the others
+static void* worker_main(void* arg){
+    pipe_worker_t* w = arg;
+    pipeline_t* p = w->owner;
+    size_t workers = p->config.worker_count;
+    unsigned spins = 0;
+
+    while(!atomic_load_explicit(&p->stop, memory_order_acquire)){
+        uint32_t seq;
+        if(queue_pop(&w->queue, &seq)){
+            process_batch(p, w, seq);
+            spins = 0;
+            continue;
+        }
+
+        bool stole = false;
+        for(size_t i = 1; i < workers; i++){
+            pipe_worker_t* victim = &p->workers[(w->index + i) % workers];
+            if(queue_pop(&victim->queue, &seq)){
+                w->stolen++;
+                process_batch(p, w, seq);
+                stole = true;
+                break;
+            }
+        }
+        if(stole) spins = 0;
+        else backoff(&spins);
+    }
+    return NULL;
+}
+
+//============================ emit stage ================================
+
+// Shard thread: batches strictly in sequence order, only this shard's range
+static void* shard_main(void* arg){
+    pipe_shard_t* sh = arg;
+    pipeline_t* p = sh->owner;
+    uint32_t next = 0;
+    unsigned spins = 0;
+
+    for(;;){
+        pipe_batch_t* b = &p->batches[next & PIPE_INFLIGHT_MASK];
+        if(atomic_load_explicit(&b->ready, memory_order_acquire) != next + 1){
+            // Not processed yet. pipe_stop only sets 'stop' after a drain, so
+            // a shard waiting here at that point has nothing left to emit.
+            if(atomic_load_explicit(&p->stop, memory_order_acquire)) break;
+            backoff(&spins);
+            continue;
+        }
+        spins = 0;
+
+        uint16_t start = b->shard_start[sh->index];
+        uint16_t end = b->shard_start[sh->index + 1];
+        if(end > start){
+            p->config.emit(sh->index, &b->readings[start], end - start, p->config.emit_ctx);
+        }
+
+        atomic_fetch_sub_explicit(&b->pending, 1, memory_order_acq_rel); // last one frees the slot
+        next++;
+        atomic_store_explicit(&sh->next_seq, next, memory_order_release);
+    }
+    return NULL;
+}
+
+//============================ pipe_start ================================
+pipe_error_t pipe_start(pipeline_t* p, const pipe_config_t* config){
+
+    if((p == NULL) || (config == NULL) || (config->emit == NULL)) return PIPE_ERROR_NULL;
+    if((config->worker_count == 0) || (config->worker_count > PIPE_MAX_WORKERS)) return PIPE_ERROR_INVALID;
+    if((config->shard_count == 0) || (config->shard_count > PIPE_MAX_SHARDS)) return PIPE_ERROR_INVALID;
+
+    p->config = *config;
+    p->next_seq = 0;
+    p->open = NULL;
+    p->running = false;
+    atomic_store(&p->stop, false);
+
+    for(size_t id = 0; id < 256; id++){
+        p->shard_of[id] = (uint8_t)(id % config->shard_count);
+    }
+    for(size_t i = 0; i < PIPE_MAX_INFLIGHT; i++){
+        atomic_store(&p->batches[i].ready, 0);   // slot i first holds seq i, which needs ready == i + 1
+        atomic_store(&p->batches[i].pending, 0);
+    }
+
+    size_t started_workers = 0, started_shards = 0;
+    for(; started_workers < config->worker_count; started_workers++){
+        pipe_worker_t* w = &p->workers[started_workers];
+        atomic_store(&w->queue.head, 0);
+        atomic_store(&w->queue.tail, 0);
+        w->index = started_workers;
+        w->owner = p;
+        w->batches = 0;
+        w->stolen = 0;
+        if(pthread_create(&w->thread, NULL, worker_main, w) != 0) break;
+    }
+    if(started_workers == config->worker_count){
+        for(; started_shards < config->shard_count; started_shards++){
+            pipe_shard_t* sh = &p->shards[started_shards];
+            sh->index = started_shards;
+            sh->owner = p;
+            atomic_store(&sh->next_seq, 0);
+            if(pthread_create(&sh->thread, NULL, shard_main, sh) != 0) break;
+        }
+    }
+
+    if((started_workers < config->worker_count) || (started_shards < config->shard_count)){
+        // Nothing was published yet, so stopping right away is safe
+        atomic_store(&p->stop, true);
+        for(size_t i = 0; i < started_workers; i++) pthread_join(p->workers[i].thread, NULL);
+        for(size_t i = 0; i < started_shards; i++) pthread_join(p->shards[i].thread, NULL);
+        return PIPE_ERROR_SYSTEM;
+    }
+
+    p->running = true;
+    return PIPE_SUCCESS;
+}
+
+//============================ pipe_stop ================================
+void pipe_stop(pipeline_t* p){
+
+    if((p == NULL) || !p->running) return;
+
+    pipe_drain(p);
+    atomic_store_explicit(&p->stop, true, memory_order_release);
+
+    for(size_t i = 0; i < p->config.worker_count; i++) pthread_join(p->workers[i].thread, NULL);
+    for(size_t i = 0; i < p->config.shard_count; i++) pthread_join(p->shards[i].thread, NULL);
+    p->running = false;
+}
+
+//============================ ingest ================================
+
+// Get the next batch slot, waiting until every shard is done with its previous batch
+sensor_data_t* pipe_acquire(pipeline_t* p){
+
+    if((p == NULL) || !p->running) return NULL;
+    if(p->open != NULL) return p->open->readings; // acquired but not published yet
+
+    pipe_batch_t* b = &p->batches[p->next_seq & PIPE_INFLIGHT_MASK];
+    unsigned spins = 0;
+    while(atomic_load_explicit(&b->pending, memory_order_acquire) != 0){
+        backoff(&spins); // pipeline full: the slowest shard sets the pace
+    }
+
+    p->open = b;
+    return b->readings;
+}
+
+// Publish the acquired batch with 'count' readings
+pipe_error_t pipe_publish(pipeline_t* p, size_t count){
+
+    if(p == NULL) return PIPE_ERROR_NULL;
+    if(!p->running) return PIPE_ERROR_STOPPED;
+    if(count > PIPE_BATCH_SIZE) return PIPE_ERROR_INVALID;
+    if((p->open == NULL) && (pipe_acquire(p) == NULL)) return PIPE_ERROR_STOPPED;
+
+    pipe_batch_t* b = p->open;
+    uint32_t seq = p->next_seq++;
+    b->seq = seq;
+    b->count = (uint32_t)count;
+    atomic_store_explicit(&b->pending, (uint32_t)p->config.shard_count, memory_order_relaxed);
+
+    // Round robin; an idle worker steals if its neighbour falls behind.
+    // The release store in queue_push publishes the readings and 'pending'.
+    queue_push(&p->workers[seq % p->config.worker_count].queue, seq);
+    p->open = NULL;
+    return PIPE_SUCCESS;
+}
+
+pipe_error_t pipe_submit(pipeline_t* p, const sensor_data_t* readings, size_t count){
+
+    if((p == NULL) || ((readings == NULL) && (count > 0))) return PIPE_ERROR_NULL;
+
+    while(count > 0){
+        size_t n = (count < PIPE_BATCH_SIZE) ? count : PIPE_BATCH_SIZE;
+        sensor_data_t* dst = pipe_acquire(p);
+        if(dst == NULL) return PIPE_ERROR_STOPPED;
+        memcpy(dst, readings, n * sizeof(sensor_data_t));
+
+        pipe_error_t err = pipe_publish(p, n);
+        if(err != PIPE_SUCCESS) return err;
+        readings += n;
+        count -= n;
+    }
+    return PIPE_SUCCESS;
+}
+
+// Every shard has emitted every published batch
+void pipe_drain(pipeline_t* p){
+
+    if((p == NULL) || !p->running) return;
+
+    for(size_t s = 0; s < p->config.shard_count; s++){
+        unsigned spins = 0;
+        while(atomic_load_explicit(&p->shards[s].next_seq, memory_order_acquire) != p->next_seq){
+            backoff(&spins);
+        }
+    }
+}
+
+//============================ counters ================================
+uint64_t pipe_worker_batches(const pipeline_t* p, size_t worker){
+    return (worker < p->config.worker_count) ? p->workers[worker].batches : 0;
+}
+
+uint64_t pipe_worker_stolen(const pipeline_t* p, size_t worker){
+    return (worker < p->config.worker_count) ? p->workers[worker].stolen : 0;
+}
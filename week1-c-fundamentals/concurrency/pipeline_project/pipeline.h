@@ -0,0 +1,145 @@
+// pipeline.h
+//===========================
+// Multi-core ingest -> process -> emit pipeline for sensor_data_t.
+// - Ingest: one thread fills batches of readings and publishes them
+// - Process: a stateless stage run by a pool of worker threads; each worker
+//   has its own queue and steals from the others when it runs dry
+// - Emit: a stateful stage split into shards by sensor_id; each shard runs on
+//   its own thread and sees its readings in the order they were published
+// Stages are connected by rings of batch sequence numbers; a batch of
+// readings is the unit of work.
+//===========================
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "../../data_structures/sensor_data_project/sensor_data.h"
+
+#define PIPE_BATCH_SIZE 256       // readings per batch (256 * 16 B = 4 KB)
+#define PIPE_MAX_INFLIGHT 64      // batches between ingest and emit, power of two
+#define PIPE_MAX_WORKERS 16       // process stage threads
+#define PIPE_MAX_SHARDS 8         // emit stage threads
+#define PIPE_CACHE_LINE 64
+
+//================================= Error Codes ==============================//
+typedef enum {
+    PIPE_SUCCESS,         // Operation succeeded
+    PIPE_ERROR_NULL,      // Provided pointer is NULL
+    PIPE_ERROR_INVALID,   // Bad worker/shard count or batch size
+    PIPE_ERROR_SYSTEM,    // Thread creation failed
+    PIPE_ERROR_STOPPED    // Pipeline is not running
+} pipe_error_t;
+
+//================================= Stage Functions ============================//
+/*
+Process stage: stateless, runs on any worker, batches in any order and in parallel.
+It may change readings in place and may drop readings by compacting the array
+(keep the relative order of the ones it keeps). Returns the new count.
+*/
+typedef size_t (*pipe_process_fn)(sensor_data_t* readings, size_t count, void* ctx);
+
+/*
+Emit stage: stateful, called on the thread of shard 'shard' with the readings
+whose sensor_id % shard_count == shard. For every sensor_id, readings arrive in
+the order they were published, so per-sensor state needs no locks.
+*/
+typedef void (*pipe_emit_fn)(size_t shard, const sensor_data_t* readings, size_t count, void* ctx);
+
+typedef struct {
+    size_t worker_count;        // 1 .. PIPE_MAX_WORKERS
+    size_t shard_count;         // 1 .. PIPE_MAX_SHARDS
+    pipe_process_fn process;    // may be NULL (pass-through)
+    void* process_ctx;          // shared by all workers: must be read-only
+    pipe_emit_fn emit;
+    void* emit_ctx;             // emit_ctx is shared too; index per-shard state by 'shard'
+} pipe_config_t;
+
+//================================= Internal Layout ============================//
+/*
+One batch = one slot of the in-flight pool. Batch 'seq' always lives in
+slot seq % PIPE_MAX_INFLIGHT, so the pool doubles as the reorder ring in
+front of the emit stage:
+
+ ingest: wait pending == 0, fill, pending = shard_count, push seq to a worker queue
+ worker: process, stable-partition by shard, ready = seq + 1
+ shard:  wait ready == next_seq + 1, emit its range, pending--
+*/
+typedef struct {
+    _Alignas(PIPE_CACHE_LINE) _Atomic uint32_t ready;  // seq + 1 once processed
+    _Atomic uint32_t pending;                          // shards that still have to emit it
+    uint32_t seq;
+    uint32_t count;
+    uint16_t shard_start[PIPE_MAX_SHARDS + 1];         // readings of shard s: [shard_start[s], shard_start[s+1])
+    sensor_data_t readings[PIPE_BATCH_SIZE];
+} pipe_batch_t;
+
+/*
+Worker queue: ring of batch sequence numbers.
+Single producer (ingest writes head), multiple consumers: the owner and any
+thief take from tail with a CAS. Capacity = PIPE_MAX_INFLIGHT, so it can
+never overflow (there are never more batches in flight).
+*/
+typedef struct {
+    _Alignas(PIPE_CACHE_LINE) _Atomic uint64_t head;
+    _Alignas(PIPE_CACHE_LINE) _Atomic uint64_t tail;
+    _Atomic uint32_t slots[PIPE_MAX_INFLIGHT];
+} pipe_queue_t;
+
+typedef struct {
+    pipe_queue_t queue;
+    pthread_t thread;
+    size_t index;
+    struct pipeline* owner;
+    _Alignas(PIPE_CACHE_LINE) uint64_t batches;   // batches processed (own + stolen), read after pipe_stop
+    uint64_t stolen;                              // batches taken from another worker's queue
+    sensor_data_t scratch[PIPE_BATCH_SIZE];       // partition buffer
+} pipe_worker_t;
+
+typedef struct {
+    pthread_t thread;
+    size_t index;
+    struct pipeline* owner;
+    _Alignas(PIPE_CACHE_LINE) _Atomic uint32_t next_seq;  // next batch to emit
+} pipe_shard_t;
+
+typedef struct pipeline {
+    pipe_config_t config;
+    pipe_batch_t batches[PIPE_MAX_INFLIGHT];
+    pipe_worker_t workers[PIPE_MAX_WORKERS];
+    pipe_shard_t shards[PIPE_MAX_SHARDS];
+    uint8_t shard_of[256];          // sensor_id -> shard (sensor_id % shard_count)
+    uint32_t next_seq;              // ingest only: sequence of the next batch
+    pipe_batch_t* open;             // ingest only: batch handed out by pipe_acquire
+    _Atomic bool stop;
+    bool running;
+} pipeline_t;
+
+//================================= Function Prototypes =======================//
+// Start the worker and shard threads. 'p' is large (~300 KB): make it static or heap allocated.
+pipe_error_t pipe_start(pipeline_t* p, const pipe_config_t* config);
+
+// Wait until everything published has been emitted, then stop all threads
+void pipe_stop(pipeline_t* p);
+
+// Ingest side (one thread only). Zero-copy: get a batch, fill up to
+// PIPE_BATCH_SIZE readings in place, then publish it. Blocks while all
+// PIPE_MAX_INFLIGHT batches are still in the pipeline.
+sensor_data_t* pipe_acquire(pipeline_t* p);
+pipe_error_t pipe_publish(pipeline_t* p, size_t count);
+
+// Copying convenience: splits 'readings' into batches and publishes them
+pipe_error_t pipe_submit(pipeline_t* p, const sensor_data_t* readings, size_t count);
+
+// Block until every published batch has been emitted by every shard
+void pipe_drain(pipeline_t* p);
+
+// Counters for the benchmark (read them after pipe_stop)
+uint64_t pipe_worker_batches(const pipeline_t* p, size_t worker);
+uint64_t pipe_worker_stolen(const pipeline_t* p, size_t worker);
+
+#endif // PIPELINE_H
@@ -0,0 +1,210 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "shm_ring.h"
+
+#define RING_NAME "/sensor_ring_demo"
+#define BURST_READINGS 2000000   // readings sent as fast as possible
+#define PACED_READINGS 20000     // readings sent one by one with a gap
+#define PACED_GAP_NS 20000       // 20 us between paced readings
+
+
+// Monotonic time in nanoseconds
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Used by qsort to sort latency samples
+static int compare_u32(const void* a, const void* b){
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Print the percentile value from an already sorted array
+static void print_percentiles(const uint32_t* sorted, size_t n){
+    printf("  latency ns: p50=%u p90=%u p99=%u p99.9=%u max=%u\n",
+           sorted[n * 50 / 100],
+           sorted[n * 90 / 100],
+           sorted[n * 99 / 100],
+           sorted[n * 999 / 1000],
+           sorted[n - 1]);
+}
+
+//============================== consumer process ==============================
+// Runs in the child: receive 'expected' readings, measure throughput and latency.
+// The producer puts the low 32 bits of its send time (ns) in 'timestamp',
+// so unsigned subtraction gives the latency as long as it is below ~4 s.
+static int run_consumer(size_t expected){
+    shm_ring_t ring;
+    shm_ring_error_t err = shm_ring_attach(&ring, RING_NAME, SHM_ROLE_CONSUMER);
+    if(err != SHM_SUCCESS){
+        printf("Consumer attach failed, error code: %d\n", err);
+        return 1;
+    }
+
+    uint32_t* latency = malloc(expected * sizeof(uint32_t));
+    if(latency == NULL){
+        shm_ring_detach(&ring);
+        return 1;
+    }
+
+    size_t received = 0;
+    uint64_t start = 0;
+    sensor_data_t reading;
+
+    while(received < expected){
+        err = shm_ring_dequeue(&ring, &reading);
+        if(err == SHM_ERROR_EMPTY){
+            err = shm_ring_wait(&ring, 1000);
+            if(err == SHM_ERROR_PEER_GONE) break; // producer died, stop early
+            continue;
+        }
+        uint64_t now = now_ns();
+        if(received == 0) start = now;
+        latency[received++] = (uint32_t)now - reading.timestamp;
+    }
+    uint64_t elapsed = now_ns() - start;
+
+    printf("  received %zu readings in %.3f ms -> %.2f M readings/s\n",
+           received, elapsed / 1e6, (elapsed > 0) ? received * 1e3 / elapsed : 0.0);
+
+    if(received > 0){
+        qsort(latency, received, sizeof(uint32_t), compare_u32);
+        print_percentiles(latency, received);
+    }
+
+    fflush(stdout); // child leaves with _exit, which does not flush stdio
+    free(latency);
+    shm_ring_detach(&ring);
+    return (received == expected) ? 0 : 1;
+}
+
+//============================== producer side ==============================
+// Runs in the parent: send 'count' readings, optionally waiting 'gap_ns' between them
+static void run_producer(shm_ring_t* ring, size_t count, uint64_t gap_ns){
+
+    // Wait for the consumer to attach before sending
+    while(!shm_ring_peer_alive(ring)){
+        usleep(1000);
+    }
+
+    sensor_data_t reading = create_sensor_data(25.0f, 40.0f, 1);
+    for(size_t i = 0; i < count; i++){
+        if(gap_ns > 0){
+            uint64_t until = now_ns() + gap_ns;
+            while(now_ns() < until){ } // busy-wait, sleeping would be too coarse
+        }
+
+        reading.temperature = 20.0f + (float)(i % 100) / 10.0f;
+        reading.timestamp = (uint32_t)now_ns();
+
+        while(shm_ring_enqueue(ring, &reading) == SHM_ERROR_FULL){
+            if(shm_ring_wait(ring, 1000) == SHM_ERROR_PEER_GONE) return;
+            reading.timestamp = (uint32_t)now_ns(); // restamp, time spent full is not latency
+        }
+    }
+}
+
+// Fork a consumer, feed it 'count' readings and wait for it to finish
+static void run_benchmark(const char* label, size_t count, uint64_t gap_ns){
+    printf("%s: %zu readings\n", label, count);
+    fflush(stdout); // don't let the child inherit unflushed output
+
+    shm_ring_t producer;
+    shm_ring_error_t err = shm_ring_attach(&producer, RING_NAME, SHM_ROLE_PRODUCER);
+    if(err != SHM_SUCCESS){
+        printf("Producer attach failed, error code: %d\n", err);
+        return;
+    }
+
+    pid_t child = fork();
+    if(child == 0){
+        _exit(run_consumer(count));
+    }
+
+    run_producer(&producer, count, gap_ns);
+
+    int status;
+    waitpid(child, &status, 0);
+    shm_ring_detach(&producer);
+    printf("------------------------------------------------------------\n");
+}
+
+
+int main()
+{
+    shm_ring_unlink(RING_NAME); // remove leftovers from a previous crashed run
+
+    //============================== Functional demo ==============================
+    printf("Shared memory ring demo (same process, both roles):\n\n");
+
+    // Consumer first: the two sides may start in either order
+    shm_ring_t tx, rx;
+    shm_ring_error_t err = shm_ring_attach(&rx, RING_NAME, SHM_ROLE_CONSUMER);
+    if(err != SHM_SUCCESS){
+        printf("Error attaching consumer, error code: %d\n", err);
+        return 1;
+    }
+    printf("Wait before any producer attached -> error code: %d (expected %d = SHM_ERROR_TIMEOUT)\n",
+           shm_ring_wait(&rx, 100), SHM_ERROR_TIMEOUT);
+    err = shm_ring_attach(&tx, RING_NAME, SHM_ROLE_PRODUCER);
+    if(err != SHM_SUCCESS){
+        printf("Error attaching producer, error code: %d\n", err);
+        return 1;
+    }
+
+    sensor_data_t a = create_sensor_data(23.5, 45.0, 1);
+    sensor_data_t b = create_sensor_data(19.8, 60.5, 2);
+    shm_ring_enqueue(&tx, &a);
+    shm_ring_enqueue(&tx, &b);
+    printf("Count after 2 enqueues: %zu\n", shm_ring_count(&rx));
+
+    sensor_data_t out;
+    while(shm_ring_dequeue(&rx, &out) == SHM_SUCCESS){
+        print_sensor_data(&out);
+    }
+
+    // A second producer must be refused while the first one is attached
+    shm_ring_t other;
+    err = shm_ring_attach(&other, RING_NAME, SHM_ROLE_PRODUCER);
+    printf("Second producer attach -> error code: %d (expected %d = SHM_ERROR_BUSY)\n", err, SHM_ERROR_BUSY);
+
+    shm_ring_detach(&tx);
+    printf("Consumer sees producer alive after detach? %s\n", shm_ring_peer_alive(&rx) ? "Yes" : "No");
+    printf("Wait on empty ring after the producer left -> error code: %d (expected %d = SHM_ERROR_PEER_GONE)\n",
+           shm_ring_wait(&rx, 100), SHM_ERROR_PEER_GONE);
+    shm_ring_detach(&rx);
+    printf("------------------------------------------------------------\n");
+
+    //============================== Cross-process benchmark ==============================
+    run_benchmark("Burst (max throughput)", BURST_READINGS, 0);
+    run_benchmark("Paced (wakeup latency, 20 us gap)", PACED_READINGS, PACED_GAP_NS);
+
+    //============================== Liveness after crash ==============================
+    printf("Crash detection:\n");
+    shm_ring_attach(&tx, RING_NAME, SHM_ROLE_PRODUCER);
+    fflush(stdout);
+    pid_t child = fork();
+    if(child == 0){
+        shm_ring_t crash;
+        shm_ring_attach(&crash, RING_NAME, SHM_ROLE_CONSUMER);
+        _exit(0); // exit WITHOUT detaching, like a crash
+    }
+    waitpid(child, NULL, 0);
+    printf("Producer sees dead consumer alive? %s\n", shm_ring_peer_alive(&tx) ? "Yes" : "No");
+
+    // The stale pid is taken over by the next consumer
+    err = shm_ring_attach(&rx, RING_NAME, SHM_ROLE_CONSUMER);
+    printf("New consumer attach after crash -> error code: %d\n", err);
+    shm_ring_detach(&rx);
+    shm_ring_detach(&tx);
+
+    shm_ring_unlink(RING_NAME);
+    return 0;
+}
@@ -0,0 +1,361 @@
+// shm_ring.c
+//===========================
+// Lock-free single-producer / single-consumer ring in POSIX shared memory.
+// The producer only writes 'head', the consumer only writes 'tail', so no
+// lock is needed: each side publishes its counter with a release store and
+// reads the other side's counter with an acquire load.
+// Sleeping and waking use a futex on a word inside the segment, which works
+// across processes without having to pass file descriptors around.
+//===========================
+
+#define _GNU_SOURCE
+#include "shm_ring.h"
+#include <errno.h>
+#include <fcntl.h>       // for O_* constants
+#include <signal.h>      // for kill()
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>    // for shm_open, mmap
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#define SHM_RING_MAGIC 0x53524E32u     // "SRN2": bump when shm_ring_shared_t changes
+#define SHM_RING_MASK (SHM_RING_CAPACITY - 1)
+#define SHM_RING_SPIN_LIMIT 2000        // polls before going to sleep in the kernel
+#define SHM_RING_WAIT_SLICE_MS 100      // max sleep before re-checking peer liveness
+#define SHM_RING_ATTACH_RETRIES 1000    // 1000 * 1ms while another process initializes
+
+_Static_assert((SHM_RING_CAPACITY & SHM_RING_MASK) == 0, "SHM_RING_CAPACITY must be a power of two");
+
+//========================= futex helpers =================================
+/*
+Private helpers around the raw futex syscall.
+Not FUTEX_PRIVATE_FLAG: the word is shared between processes.
+*/
+static void futex_wait(_Atomic uint32_t* word, uint32_t expected, int timeout_ms) {
+    struct timespec ts;
+    ts.tv_sec = timeout_ms / 1000;
+    ts.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAIT, expected, &ts, NULL, 0);
+}
+
+static void futex_wake(_Atomic uint32_t* word) {
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+// Bump the futex word and wake the other side, but only if it said it is asleep
+static void notify_peer(_Atomic uint32_t* waiting, _Atomic uint32_t* seq) {
+    // Full fence: our counter store must be visible before we look at 'waiting',
+    // otherwise the peer could check the counter, miss it, and sleep forever
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(waiting, memory_order_relaxed)) {
+        atomic_fetch_add_explicit(seq, 1, memory_order_release);
+        futex_wake(seq);
+    }
+}
+
+//========================= process_alive =================================
+// kill(pid, 0) sends no signal, it only checks that the process exists
+static bool process_alive(uint32_t pid) {
+    if (pid == 0) return false;
+    return (kill((pid_t)pid, 0) == 0) || (errno == EPERM);
+}
+
+static uint64_t now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u;
+}
+
+//========================= map_segment =================================
+/*
+Open or create the segment and map it:
+- The process that manages to create it (O_EXCL) sizes and initializes it,
+  then publishes 'magic' last.
+- Everybody else waits until 'magic' is visible before using the ring.
+*/
+static shm_ring_error_t map_segment(const char* name, shm_ring_shared_t** out) {
+    bool creator = true;
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+
+    if (fd < 0 && errno == EEXIST) {
+        creator = false;
+        fd = shm_open(name, O_RDWR, 0600);
+    }
+    if (fd < 0) return SHM_ERROR_SYSTEM;
+
+    if (creator) {
+        if (ftruncate(fd, sizeof(shm_ring_shared_t)) != 0) {
+            close(fd);
+            shm_unlink(name);
+            return SHM_ERROR_SYSTEM;
+        }
+    } else {
+        // Creator may still be between shm_open and ftruncate
+        struct stat st;
+        int retries = 0;
+        while ((fstat(fd, &st) == 0) && ((size_t)st.st_size < sizeof(shm_ring_shared_t))) {
+            if (++retries > SHM_RING_ATTACH_RETRIES) {
+                close(fd);
+                return SHM_ERROR_INVALID;
+            }
+            usleep(1000);
+        }
+    }
+
+    void* p = mmap(NULL, sizeof(shm_ring_shared_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // the mapping keeps the segment alive, fd no longer needed
+    if (p == MAP_FAILED) return SHM_ERROR_SYSTEM;
+
+    shm_ring_shared_t* s = p;
+    if (creator) {
+        // ftruncate already zero-filled the memory; only set the non-zero fields
+        s->capacity = SHM_RING_CAPACITY;
+        s->layout_size = sizeof(shm_ring_shared_t);
+        atomic_thread_fence(memory_order_release);
+        s->magic = SHM_RING_MAGIC;
+    } else {
+        int retries = 0;
+        while (*(volatile uint32_t*)&s->magic != SHM_RING_MAGIC) {
+            if (++retries > SHM_RING_ATTACH_RETRIES) {
+                munmap(p, sizeof(shm_ring_shared_t));
+                return SHM_ERROR_INVALID;
+            }
+            usleep(1000);
+        }
+        atomic_thread_fence(memory_order_acquire);
+        if ((s->capacity != SHM_RING_CAPACITY) || (s->layout_size != sizeof(shm_ring_shared_t))) {
+            munmap(p, sizeof(shm_ring_shared_t));
+            return SHM_ERROR_INVALID; // built with a different SHM_RING_CAPACITY or struct layout
+        }
+    }
+
+    *out = s;
+    return SHM_SUCCESS;
+}
+
+//========================= claim_role =================================
+/*
+Write our pid into the role slot.
+If the slot holds the pid of a process that died without detaching,
+we take it over; if that process is still alive the role is BUSY.
+*/
+static shm_ring_error_t claim_role(_Atomic uint32_t* slot) {
+    uint32_t me = (uint32_t)getpid();
+    uint32_t current = atomic_load(slot);
+
+    while (true) {
+        if ((current != 0) && process_alive(current)) return SHM_ERROR_BUSY;
+        if (atomic_compare_exchange_weak(slot, &current, me)) return SHM_SUCCESS;
+        // CAS failed: 'current' now holds the new value, check it again
+    }
+}
+
+//================================ shm_ring_attach =================================
+shm_ring_error_t shm_ring_attach(shm_ring_t* ring, const char* name, shm_ring_role_t role) {
+
+    if ((ring == NULL) || (name == NULL)) return SHM_ERROR_NULL;
+    if (strlen(name) >= SHM_RING_NAME_MAX) return SHM_ERROR_INVALID;
+
+    shm_ring_shared_t* s = NULL;
+    shm_ring_error_t err = map_segment(name, &s);
+    if (err != SHM_SUCCESS) return err;
+
+    err = claim_role((role == SHM_ROLE_PRODUCER) ? &s->producer_pid : &s->consumer_pid);
+    if (err != SHM_SUCCESS) {
+        munmap(s, sizeof(shm_ring_shared_t));
+        return err;
+    }
+
+    ring->shared = s;
+    ring->role = role;
+    strcpy(ring->name, name);
+
+    // Announce the attach, then note whether the other side is (or was) there
+    _Atomic uint32_t* my_attaches = (role == SHM_ROLE_PRODUCER) ? &s->producer_attaches : &s->consumer_attaches;
+    _Atomic uint32_t* peer_attaches = (role == SHM_ROLE_PRODUCER) ? &s->consumer_attaches : &s->producer_attaches;
+    atomic_fetch_add(my_attaches, 1);
+    ring->peer_attaches = atomic_load(peer_attaches);
+    ring->peer_seen = shm_ring_peer_alive(ring);
+
+    // Producer caches the consumer's tail, consumer caches the producer's head
+    ring->cached_peer = (role == SHM_ROLE_PRODUCER) ? atomic_load_explicit(&s->tail, memory_order_acquire)
+                                                    : atomic_load_explicit(&s->head, memory_order_acquire);
+    return SHM_SUCCESS;
+}
+
+//================================ shm_ring_detach =================================
+shm_ring_error_t shm_ring_detach(shm_ring_t* ring) {
+
+    if ((ring == NULL) || (ring->shared == NULL)) return SHM_ERROR_NULL;
+
+    shm_ring_shared_t* s = ring->shared;
+    uint32_t me = (uint32_t)getpid();
+
+    if (ring->role == SHM_ROLE_PRODUCER) {
+        atomic_compare_exchange_strong(&s->producer_pid, &me, 0);
+        // Wake a sleeping consumer so it notices we are gone
+        atomic_fetch_add_explicit(&s->data_seq, 1, memory_order_release);
+        futex_wake(&s->data_seq);
+    } else {
+        atomic_compare_exchange_strong(&s->consumer_pid, &me, 0);
+        atomic_fetch_add_explicit(&s->space_seq, 1, memory_order_release);
+        futex_wake(&s->space_seq);
+    }
+
+    munmap(s, sizeof(shm_ring_shared_t));
+    ring->shared = NULL;
+    return SHM_SUCCESS;
+}
+
+//================================ shm_ring_unlink =================================
+shm_ring_error_t shm_ring_unlink(const char* name) {
+    if (name == NULL) return SHM_ERROR_NULL;
+    return (shm_unlink(name) == 0) ? SHM_SUCCESS : SHM_ERROR_SYSTEM;
+}
+
+//================================ shm_ring_enqueue ==============================
+// Add a reading to the ring (producer side)
+shm_ring_error_t shm_ring_enqueue(shm_ring_t* ring, const sensor_data_t* data) {
+
+    if ((ring == NULL) || (ring->shared == NULL) || (data == NULL)) return SHM_ERROR_NULL;
+
+    shm_ring_shared_t* s = ring->shared;
+    uint64_t head = atomic_load_explicit(&s->head, memory_order_relaxed); // only we write head
+
+    // Only touch the consumer's cache line when our cached tail says "full"
+    if (head - ring->cached_peer >= SHM_RING_CAPACITY) {
+        ring->cached_peer = atomic_load_explicit(&s->tail, memory_order_acquire);
+        if (head - ring->cached_peer >= SHM_RING_CAPACITY) return SHM_ERROR_FULL;
+    }
+
+    s->slots[head & SHM_RING_MASK] = *data;  // copy reading into its slot
+
+    // Release: the slot contents become visible before the new head does
+    atomic_store_explicit(&s->head, head + 1, memory_order_release);
+    notify_peer(&s->consumer_waiting, &s->data_seq);
+
+    return SHM_SUCCESS;
+}
+
+//================================ shm_ring_dequeue ==============================
+// Remove the oldest reading from the ring (consumer side)
+shm_ring_error_t shm_ring_dequeue(shm_ring_t* ring, sensor_data_t* out_item) {
+
+    if ((ring == NULL) || (ring->shared == NULL) || (out_item == NULL)) return SHM_ERROR_NULL;
+
+    shm_ring_shared_t* s = ring->shared;
+    uint64_t tail = atomic_load_explicit(&s->tail, memory_order_relaxed); // only we write tail
+
+    if (tail == ring->cached_peer) {
+        ring->cached_peer = atomic_load_explicit(&s->head, memory_order_acquire);
+        if (tail == ring->cached_peer) return SHM_ERROR_EMPTY;
+    }
+
+    *out_item = s->slots[tail & SHM_RING_MASK]; // copy oldest reading out
+
+    // Release: we are done reading the slot before the producer may reuse it
+    atomic_store_explicit(&s->tail, tail + 1, memory_order_release);
+    notify_peer(&s->producer_waiting, &s->space_seq);
+
+    return SHM_SUCCESS;
+}
+
+//================================ ready_to_go ===================================
+// Consumer: is there data? Producer: is there space?
+static bool ready_to_go(const shm_ring_t* ring) {
+    const shm_ring_shared_t* s = ring->shared;
+    uint64_t head = atomic_load_explicit(&s->head, memory_order_acquire);
+    uint64_t tail = atomic_load_explicit(&s->tail, memory_order_acquire);
+
+    if (ring->role == SHM_ROLE_CONSUMER) return head != tail;
+    return (head - tail) < SHM_RING_CAPACITY;
+}
+
+//================================ peer_left ===================================
+/*
+Peer not alive: did it leave, or has it just not attached yet?
+Only "was there, now gone" counts as gone. A peer is "seen" if it was alive
+at one of our checks or its attach counter moved since our attach (that
+catches a peer that came and went between two checks).
+*/
+static bool peer_left(shm_ring_t* ring) {
+    if (shm_ring_peer_alive(ring)) {
+        ring->peer_seen = true;
+        return false;
+    }
+    const shm_ring_shared_t* s = ring->shared;
+    uint32_t attaches = atomic_load((ring->role == SHM_ROLE_PRODUCER) ? &s->consumer_attaches : &s->producer_attaches);
+    if (attaches != ring->peer_attaches) ring->peer_seen = true;
+    return ring->peer_seen;
+}
+
+//================================ shm_ring_wait =================================
+/*
+Block until the ring has something for us:
+1. Spin for a short while (cheap when the peer is fast).
+2. Announce we are waiting, re-check, then sleep on the futex word.
+3. Sleep in slices so a peer that died without detaching is still noticed.
+   A peer that has never attached is waited for, up to the timeout.
+*/
+shm_ring_error_t shm_ring_wait(shm_ring_t* ring, int timeout_ms) {
+
+    if ((ring == NULL) || (ring->shared == NULL)) return SHM_ERROR_NULL;
+
+    shm_ring_shared_t* s = ring->shared;
+    bool consumer = (ring->role == SHM_ROLE_CONSUMER);
+    _Atomic uint32_t* waiting = consumer ? &s->consumer_waiting : &s->producer_waiting;
+    _Atomic uint32_t* seq = consumer ? &s->data_seq : &s->space_seq;
+    uint64_t deadline = (timeout_ms < 0) ? UINT64_MAX : now_ms() + (uint64_t)timeout_ms;
+
+    for (int i = 0; i < SHM_RING_SPIN_LIMIT; i++) {
+        if (ready_to_go(ring)) return SHM_SUCCESS;
+    }
+
+    while (true) {
+        uint32_t observed = atomic_load_explicit(seq, memory_order_acquire);
+        atomic_store(waiting, 1);
+        // Full fence, mirroring notify_peer(): the 'waiting' store must be visible before
+        // ready_to_go() loads the counters, or both sides can miss each other
+        atomic_thread_fence(memory_order_seq_cst);
+
+        if (ready_to_go(ring)) {
+            atomic_store(waiting, 0);
+            return SHM_SUCCESS;
+        }
+        if (peer_left(ring)) {
+            atomic_store(waiting, 0);
+            return SHM_ERROR_PEER_GONE;
+        }
+
+        uint64_t now = now_ms();
+        if (now >= deadline) {
+            atomic_store(waiting, 0);
+            return SHM_ERROR_TIMEOUT;
+        }
+        uint64_t left = deadline - now;
+        futex_wait(seq, observed, (left < SHM_RING_WAIT_SLICE_MS) ? (int)left : SHM_RING_WAIT_SLICE_MS);
+    }
+}
+
+//================================ shm_ring_peer_alive ===========================
+bool shm_ring_peer_alive(const shm_ring_t* ring) {
+    if ((ring == NULL) || (ring->shared == NULL)) return false;
+
+    const shm_ring_shared_t* s = ring->shared;
+    uint32_t pid = (ring->role == SHM_ROLE_PRODUCER) ? atomic_load(&s->consumer_pid)
+                                                     : atomic_load(&s->producer_pid);
+    return process_alive(pid);
+}
+
+//================================ shm_ring_count ================================
+// Number of readings currently waiting in the ring
+size_t shm_ring_count(const shm_ring_t* ring) {
+    if ((ring == NULL) || (ring->shared == NULL)) return 0;
+
+    uint64_t tail = atomic_load_explicit(&ring->shared->tail, memory_order_acquire);
+    uint64_t head = atomic_load_explicit(&ring->shared->head, memory_order_acquire);
+    return (size_t)(head - tail);
+}
@@ -0,0 +1,125 @@
+// shm_ring.h
+//===========================
+// Header for a shared-memory ring of sensor_data_t.
+// One producer process and one consumer process exchange readings through
+// a named POSIX shared memory segment (single-producer / single-consumer,
+// lock-free). Contains the shared layout, error codes and function prototypes.
+//===========================
+
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>     // for size_t
+#include <stdatomic.h>
+#include <sys/types.h>  // for pid_t
+#include "../../data_structures/sensor_data_project/sensor_data.h"
+
+// Number of slots in the ring. MUST be a power of two so the index can be
+// computed with a mask instead of the (slow) modulo used in circular_buffer.c
+#define SHM_RING_CAPACITY 4096
+
+// Max length of the segment name, e.g. "/sensor_ring"
+#define SHM_RING_NAME_MAX 64
+
+// Size of a cache line; producer and consumer fields are kept on separate
+// lines so the two processes don't keep stealing the same line from each other
+#define SHM_RING_CACHE_LINE 64
+
+//================================= Error Codes ==============================//
+typedef enum {
+    SHM_SUCCESS,          // Operation succeeded
+    SHM_ERROR_FULL,       // Ring is full, cannot enqueue
+    SHM_ERROR_EMPTY,      // Ring is empty, cannot dequeue
+    SHM_ERROR_NULL,       // Provided pointer is NULL
+    SHM_ERROR_SYSTEM,     // shm_open / ftruncate / mmap failed (check errno)
+    SHM_ERROR_BUSY,       // Another process already holds this role
+    SHM_ERROR_INVALID,    // Segment exists but is not a valid ring
+    SHM_ERROR_TIMEOUT,    // Wait timed out (also while the other side has never attached)
+    SHM_ERROR_PEER_GONE   // The other process was attached, then detached or died
+} shm_ring_error_t;
+
+// Which side of the ring this process is
+typedef enum {
+    SHM_ROLE_PRODUCER,
+    SHM_ROLE_CONSUMER
+} shm_ring_role_t;
+
+//================================= Shared Layout ============================//
+/*
+This struct lives inside the shared memory segment, so BOTH processes see
+the same bytes. It must not contain pointers (each process maps the
+segment at a different address).
+
+    [ header | head (producer line) | tail (consumer line) | slots[...] ]
+
+head = total number of readings ever written (only producer writes it)
+tail = total number of readings ever read    (only consumer writes it)
+count = head - tail, slot index = counter & (SHM_RING_CAPACITY - 1)
+*/
+typedef struct {
+    // Read-only after creation
+    uint32_t magic;        // SHM_RING_MAGIC once the segment is initialized
+    uint32_t capacity;     // SHM_RING_CAPACITY, checked on attach
+    uint32_t layout_size;  // sizeof(shm_ring_shared_t), checked on attach
+
+    // Producer-owned cache line
+    _Alignas(SHM_RING_CACHE_LINE) _Atomic uint64_t head;
+    _Atomic uint32_t data_seq;        // futex word: bumped after each publish
+    _Atomic uint32_t producer_pid;    // 0 when no producer is attached
+    _Atomic uint32_t producer_attaches; // bumped on every producer attach
+
+    // Consumer-owned cache line
+    _Alignas(SHM_RING_CACHE_LINE) _Atomic uint64_t tail;
+    _Atomic uint32_t space_seq;       // futex word: bumped after each consume
+    _Atomic uint32_t consumer_pid;    // 0 when no consumer is attached
+    _Atomic uint32_t consumer_attaches; // bumped on every consumer attach
+
+    // Wakeup flags: set by a side before it sleeps so the other side only
+    // pays for a futex syscall when someone is really waiting
+    _Alignas(SHM_RING_CACHE_LINE) _Atomic uint32_t consumer_waiting;
+    _Atomic uint32_t producer_waiting;
+
+    _Alignas(SHM_RING_CACHE_LINE) sensor_data_t slots[SHM_RING_CAPACITY];
+} shm_ring_shared_t;
+
+//================================= Local Handle =============================//
+// Per-process handle: where the segment is mapped and which role we have
+typedef struct {
+    shm_ring_shared_t* shared;      // mapped segment (NULL when detached)
+    shm_ring_role_t role;           // producer or consumer
+    uint64_t cached_peer;           // last seen tail (producer) or head (consumer)
+    bool peer_seen;                 // the other side has been attached since our attach
+    uint32_t peer_attaches;         // its attach counter when we attached
+    char name[SHM_RING_NAME_MAX];   // segment name, needed for unlink
+} shm_ring_t;
+
+//================================= Function Prototypes =======================//
+// Attach to (and create if needed) the named segment in the given role.
+// Only one producer and one consumer may be attached at a time.
+shm_ring_error_t shm_ring_attach(shm_ring_t* ring, const char* name, shm_ring_role_t role);
+
+// Release our role and unmap the segment. The segment itself stays alive.
+shm_ring_error_t shm_ring_detach(shm_ring_t* ring);
+
+// Remove the segment name from the system (call once, after both detached)
+shm_ring_error_t shm_ring_unlink(const char* name);
+
+// Core operations (non-blocking)
+shm_ring_error_t shm_ring_enqueue(shm_ring_t* ring, const sensor_data_t* data);   // producer only
+shm_ring_error_t shm_ring_dequeue(shm_ring_t* ring, sensor_data_t* out_item);     // consumer only
+
+// Block until there is data (consumer) or space (producer).
+// timeout_ms < 0 waits forever. Returns SHM_ERROR_PEER_GONE if the other
+// side was attached, is not any more, and nothing is left to do. If it has
+// not attached yet, keeps waiting (so the two processes can start in either order).
+shm_ring_error_t shm_ring_wait(shm_ring_t* ring, int timeout_ms);
+
+// Liveness: true if the other side is attached and its process still exists
+bool shm_ring_peer_alive(const shm_ring_t* ring);
+
+// Status checks
+size_t shm_ring_count(const shm_ring_t* ring);
+
+#endif // SHM_RING_H
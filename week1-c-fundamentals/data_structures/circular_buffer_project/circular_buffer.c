@@ -2,6 +2,10 @@
 
 #include "circular_buffer.h"
 #include <stdio.h>
+#include "../../timing/trace_project/trace.h" // TRACE_SCOPE: compiled out unless -DUSE_TRACE
+#ifdef USE_ASYNC_LOG
+#include "../../concurrency/async_log_project/async_log.h" // background writer instead of printf
+#endif
 
 //================================ cb_init =================================
 // Initialize the circular buffer
@@ -16,6 +20,7 @@ void cb_init(circular_buffer_t* cb){
 // Add a new sensor reading to the buffer
 // 'data' is marked const to prevent modification inside this function
 cb_error_t cb_enqueue(circular_buffer_t* cb, const sensor_data_t* data){
+    TRACE_SCOPE(TRACE_CB_ENQUEUE);
 
     if((cb == NULL) || (data == NULL)) return CB_ERROR_NULL; // Validate pointers
 
@@ -56,6 +61,7 @@ cb_error_t cb_enqueue_force(circular_buffer_t* cb, const sensor_data_t* data){
 // Remove the oldest sensor reading from the buffer
 // The removed item is copied into 'out_item'
 cb_error_t cb_dequeue(circular_buffer_t* cb, sensor_data_t* out_item){
+    TRACE_SCOPE(TRACE_CB_DEQUEUE);
 
     if((cb == NULL) || (out_item == NULL)) return CB_ERROR_NULL; // Validate pointers
 
@@ -102,12 +108,28 @@ size_t cb_count(const circular_buffer_t* cb){
 void cb_print_all(const circular_buffer_t* cb){
 
     if((cb == NULL) || (cb_is_empty(cb))){
+#ifdef USE_ASYNC_LOG
+        if(alog_is_running() && (alog_text("Circular buffer is empty!\n") != ALOG_ERROR_STOPPED)){
+            return;
+        }
+#endif
         printf("Circular buffer is empty!\n");
         return;
     }
 
     size_t index = cb->tail; // Start from the oldest item (tail)
-    for(size_t i = 0; i < cb->count; i++){ // Loop from tail (oldest) through all items currently in the buffer
+    size_t i = 0;
+
+#ifdef USE_ASYNC_LOG
+    if(alog_is_running()){
+        for(; i < cb->count; i++){ // same walk as below, one record per item
+            if(alog_cb_entry(index, &cb->buffer[index]) == ALOG_ERROR_STOPPED) break; // rest goes to printf
+            index = (index + 1) % cb->capacity;
+        }
+    }
+#endif
+
+    for(; i < cb->count; i++){ // Loop from tail (oldest) through all items currently in the buffer
         printf("Index %zu = ", index);
         printf("Temperature: %.2f | Humidity: %.2f%% | Sensor ID: %u | Status: %u | Timestamp: %u\n",
                cb->buffer[index].temperature,
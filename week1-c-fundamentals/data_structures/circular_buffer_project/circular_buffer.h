@@ -6,6 +6,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>   // for size_t
 #include "../sensor_data_project/sensor_data.h"
 
 // Maximum number of items in the circular buffer
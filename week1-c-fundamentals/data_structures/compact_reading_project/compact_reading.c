@@ -0,0 +1,361 @@
+// Functions implementation
+
+#include "compact_reading.h"
+#include <stdio.h>
+#include <math.h>   // for sqrt
+
+_Static_assert(sizeof(compact_reading_t) == 8, "compact_reading_t must stay 8 bytes");
+
+//================================ conversion helpers ===========================
+// Private helpers shared by cr_pack/cr_unpack and the buffer
+
+// Round value * scale to the nearest integer (halves away from zero).
+// Returns false if the result is outside [lo, hi] (or the value is NaN).
+// Both bounds are strict: lo - 0.5 would round to lo - 1 and hi + 0.5 to hi + 1.
+static bool to_fixed(float value, int scale, int32_t lo, int32_t hi, int32_t* out){
+    double x = (double)value * scale; // double: 23.45f * 100 in float is 2344.9999
+    if(!((x > lo - 0.5) && (x < hi + 0.5))) return false; // also false for NaN
+    *out = (int32_t)(x >= 0.0 ? x + 0.5 : x - 0.5);
+    return true;
+}
+
+// Fill a sensor_data_t from a compact reading whose absolute timestamp is known
+static void decode(const compact_reading_t* in, uint32_t timestamp, sensor_data_t* out){
+    out->timestamp = timestamp;
+    out->temperature = cr_temperature(in);
+    out->humidity = cr_humidity(in);
+    out->sensor_id = in->sensor_id;
+    out->status = in->status;
+}
+
+//================================ cr_pack =================================
+// Convert a sensor_data_t to a compact reading. Nothing is written on error.
+cr_error_t cr_pack(const sensor_data_t* in, uint32_t prev_ts, compact_reading_t* out, uint32_t* out_ts){
+
+    if((in == NULL) || (out == NULL) || (out_ts == NULL)) return CR_ERROR_NULL;
+
+    int32_t temp, hum;
+    if(!to_fixed(in->temperature, CR_TEMP_SCALE, INT16_MIN, INT16_MAX, &temp)) return CR_ERROR_RANGE;
+    if(!to_fixed(in->humidity, CR_HUM_SCALE, 0, UINT16_MAX, &hum)) return CR_ERROR_RANGE;
+
+    /*
+    The delta is rounded against 'prev_ts' as the decoder will rebuild it, not
+    against the previous original timestamp. So every rebuilt timestamp is
+    within half a unit of its original, however many deltas are chained.
+    The signed cast keeps this correct when the 32-bit timestamp wraps.
+    */
+    int64_t gap = (int32_t)(in->timestamp - prev_ts);
+    if(gap < -(int64_t)(CR_TS_UNIT_US / 2)) return CR_ERROR_RANGE; // older than the previous reading
+    int64_t units = (gap + CR_TS_UNIT_US / 2) / CR_TS_UNIT_US;
+    if(units > CR_TS_DELTA_MAX) return CR_ERROR_RANGE;             // gap too large for 16 bits (needs a rebase)
+
+    out->temp_centi = (int16_t)temp;
+    out->hum_centi = (uint16_t)hum;
+    out->ts_delta = (uint16_t)units;
+    out->sensor_id = in->sensor_id;
+    out->status = in->status;
+    *out_ts = prev_ts + (uint32_t)units * CR_TS_UNIT_US;
+
+    return CR_SUCCESS;
+}
+
+//================================ cr_unpack ===============================
+// Convert a compact reading back; its timestamp is 'prev_ts' + delta
+cr_error_t cr_unpack(const compact_reading_t* in, uint32_t prev_ts, sensor_data_t* out){
+
+    if((in == NULL) || (out == NULL)) return CR_ERROR_NULL;
+    if(cr_is_rebase(in)) return CR_ERROR_RANGE; // not a reading
+
+    decode(in, prev_ts + (uint32_t)in->ts_delta * CR_TS_UNIT_US, out);
+    return CR_SUCCESS;
+}
+
+//================================ cr_pack_rebase ===========================
+// Rebase record: the absolute timestamp split over the fields after ts_delta
+void cr_pack_rebase(uint32_t timestamp, compact_reading_t* out){
+    out->temp_centi = 0;
+    out->hum_centi = (uint16_t)(timestamp & 0xFFFFu);
+    out->ts_delta = CR_TS_REBASE;
+    out->sensor_id = (uint8_t)(timestamp >> 16);
+    out->status = (uint8_t)(timestamp >> 24);
+}
+
+//================================ crb_init =================================
+// Initialize the compact buffer
+void crb_init(compact_buffer_t* cb){
+    cb->capacity = CR_BUFFER_SIZE;
+    cb->count = 0;
+    cb->rebases = 0;
+    cb->head = 0;
+    cb->tail = 0;
+    cb->tail_ts = 0;
+    cb->head_ts = 0;
+}
+
+// Encode 'data' against the newest reading. In an empty buffer the reading is
+// its own base, so its timestamp is stored exactly and any gap is accepted.
+// If the gap does not fit 16 bits, the reading is encoded against its own
+// timestamp too and *rebase is set: a rebase record has to go in front of it.
+static cr_error_t encode_next(const compact_buffer_t* cb, const sensor_data_t* data, compact_reading_t* out, uint32_t* out_ts, bool* rebase){
+    *rebase = false;
+    if(cb->count == 0) return cr_pack(data, data->timestamp, out, out_ts);
+
+    cr_error_t err = cr_pack(data, cb->head_ts, out, out_ts);
+    if(err != CR_ERROR_RANGE) return err;
+
+    // RANGE from the value check fails again here; only a gap problem passes with a zero delta
+    err = cr_pack(data, data->timestamp, out, out_ts);
+    if(err == CR_SUCCESS) *rebase = true;
+    return err;
+}
+
+// Store an encoded reading (after its rebase record, if any) at head
+static void store_at_head(compact_buffer_t* cb, const compact_reading_t* r, uint32_t ts, bool rebase){
+    if(cb->count == 0) cb->tail_ts = ts; // it is also the oldest (an empty buffer never needs a rebase)
+    if(rebase){
+        cr_pack_rebase(ts, &cb->buffer[cb->head]);
+        cb->head = (cb->head + 1) % cb->capacity;
+        cb->count++;
+        cb->rebases++;
+    }
+    cb->buffer[cb->head] = *r;
+    cb->head_ts = ts;
+    cb->head = (cb->head + 1) % cb->capacity;
+    cb->count++;
+}
+
+// Drop the reading at tail and move tail_ts to the next one.
+// A rebase record always comes just before a reading, so tail never rests on one.
+static void drop_tail(compact_buffer_t* cb){
+    cb->tail = (cb->tail + 1) % cb->capacity;
+    cb->count--;
+    if(cb->count == 0) return;
+
+    const compact_reading_t* next = &cb->buffer[cb->tail];
+    if(cr_is_rebase(next)){
+        cb->tail_ts = cr_rebase_timestamp(next);
+        cb->tail = (cb->tail + 1) % cb->capacity;
+        cb->count--;
+        cb->rebases--;
+        next = &cb->buffer[cb->tail];
+    }
+    cb->tail_ts += (uint32_t)next->ts_delta * CR_TS_UNIT_US;
+}
+
+//================================ crb_enqueue ==============================
+// Convert and add a new reading. CR_ERROR_RANGE if it does not fit the encoding.
+cr_error_t crb_enqueue(compact_buffer_t* cb, const sensor_data_t* data){
+
+    if((cb == NULL) || (data == NULL)) return CR_ERROR_NULL;
+
+    if(crb_is_full(cb)) return CR_ERROR_FULL;
+
+    compact_reading_t r;
+    uint32_t ts;
+    bool rebase;
+    cr_error_t err = encode_next(cb, data, &r, &ts, &rebase);
+    if(err != CR_SUCCESS) return err;
+    if(rebase && (cb->capacity - cb->count < 2)) return CR_ERROR_FULL;
+
+    store_at_head(cb, &r, ts, rebase);
+    return CR_SUCCESS;
+}
+
+//============================ crb_enqueue_force ============================
+// Force enqueue: overwrite the oldest reading if the buffer is full
+cr_error_t crb_enqueue_force(compact_buffer_t* cb, const sensor_data_t* data){
+
+    if((cb == NULL) || (data == NULL)) return CR_ERROR_NULL;
+
+    // Encode first, so a reading that does not fit leaves the buffer untouched
+    compact_reading_t r;
+    uint32_t ts;
+    bool rebase;
+    cr_error_t err = encode_next(cb, data, &r, &ts, &rebase);
+    if(err != CR_SUCCESS) return err;
+
+    size_t needed = rebase ? 2 : 1;
+    while(cb->capacity - cb->count < needed){
+        drop_tail(cb); // frees one reading (and its rebase record)
+    }
+    if(cb->count == 0){
+        rebase = false; // everything was evicted: the reading is its own base again
+    }
+
+    store_at_head(cb, &r, ts, rebase);
+    return CR_SUCCESS;
+}
+
+//================================ crb_dequeue ==============================
+// Remove the oldest reading and convert it back into 'out_item'
+cr_error_t crb_dequeue(compact_buffer_t* cb, sensor_data_t* out_item){
+
+    if((cb == NULL) || (out_item == NULL)) return CR_ERROR_NULL;
+
+    if(crb_is_empty(cb)) return CR_ERROR_EMPTY;
+
+    decode(&cb->buffer[cb->tail], cb->tail_ts, out_item);
+    drop_tail(cb);
+
+    return CR_SUCCESS;
+}
+
+//=============================== crb_peek =============================
+// Look at the oldest reading without dequeuing
+cr_error_t crb_peek(const compact_buffer_t* cb, sensor_data_t* out_item){
+
+    if((cb == NULL) || (out_item == NULL)) return CR_ERROR_NULL;
+    if(crb_is_empty(cb)) return CR_ERROR_EMPTY;
+
+    decode(&cb->buffer[cb->tail], cb->tail_ts, out_item);
+    return CR_SUCCESS;
+}
+
+//=============================== crb status ==============================
+bool crb_is_empty(const compact_buffer_t* cb){
+    return cb->count == 0;
+}
+
+bool crb_is_full(const compact_buffer_t* cb){
+    return cb->count == cb->capacity;
+}
+
+size_t crb_count(const compact_buffer_t* cb){
+    return cb->count - cb->rebases;
+}
+
+//============================== crb_print_all =============================
+// Print all items from oldest to newest, rebuilding timestamps along the way
+void crb_print_all(const compact_buffer_t* cb){
+
+    if((cb == NULL) || (crb_is_empty(cb))){
+        printf("Compact buffer is empty!\n");
+        return;
+    }
+
+    size_t index = cb->tail;
+    uint32_t ts = cb->tail_ts;
+    for(size_t i = 0; i < cb->count; i++){
+        const compact_reading_t* r = &cb->buffer[index];
+        if(cr_is_rebase(r)){
+            ts = cr_rebase_timestamp(r); // restart the chain, nothing to print
+            index = (index + 1) % cb->capacity;
+            continue;
+        }
+        if(i > 0) ts += (uint32_t)r->ts_delta * CR_TS_UNIT_US; // the oldest one's delta is already in tail_ts
+
+        printf("Index %zu = ", index);
+        printf("Temperature: %.2f | Humidity: %.2f%% | Sensor ID: %u | Status: %u | Timestamp: %u\n",
+               cr_temperature(r), cr_humidity(r), r->sensor_id, r->status, ts);
+
+        index = (index + 1) % cb->capacity;
+    }
+}
+
+//================================ stats helpers ===============================
+
+// Running integer sums for one sensor. Values stay in fixed point until the end:
+// sums of int16 fit easily in int64 (2^15 * 2^15 * 2^32 readings < 2^63).
+typedef struct {
+    size_t count;
+    int64_t temp_sum, temp_sumsq;
+    int64_t hum_sum, hum_sumsq;
+    int32_t temp_min, temp_max;
+    int32_t hum_min, hum_max;
+} stats_acc_t;
+
+static void acc_init(stats_acc_t* acc){
+    acc->count = 0;
+    acc->temp_sum = acc->temp_sumsq = 0;
+    acc->hum_sum = acc->hum_sumsq = 0;
+    acc->temp_min = INT16_MAX;
+    acc->temp_max = INT16_MIN;
+    acc->hum_min = UINT16_MAX;
+    acc->hum_max = 0;
+}
+
+// Add every reading of 'sensor_id' in one contiguous run of readings
+static void acc_scan(stats_acc_t* acc, const compact_reading_t* readings, size_t n, uint8_t sensor_id){
+    size_t count = 0;
+    int64_t temp_sum = 0, temp_sumsq = 0, hum_sum = 0, hum_sumsq = 0;
+    int32_t temp_min = acc->temp_min, temp_max = acc->temp_max;
+    int32_t hum_min = acc->hum_min, hum_max = acc->hum_max;
+
+    for(size_t i = 0; i < n; i++){
+        const compact_reading_t* r = &readings[i];
+        if((r->sensor_id != sensor_id) || cr_is_rebase(r)) continue;
+
+        int32_t t = r->temp_centi;
+        int32_t h = r->hum_centi;
+        count++;
+        temp_sum += t;
+        temp_sumsq += (int64_t)t * t;
+        hum_sum += h;
+        hum_sumsq += (int64_t)h * h;
+        temp_min = (t < temp_min) ? t : temp_min;
+        temp_max = (t > temp_max) ? t : temp_max;
+        hum_min = (h < hum_min) ? h : hum_min;
+        hum_max = (h > hum_max) ? h : hum_max;
+    }
+
+    acc->count += count;
+    acc->temp_sum += temp_sum;
+    acc->temp_sumsq += temp_sumsq;
+    acc->hum_sum += hum_sum;
+    acc->hum_sumsq += hum_sumsq;
+    acc->temp_min = temp_min;
+    acc->temp_max = temp_max;
+    acc->hum_min = hum_min;
+    acc->hum_max = hum_max;
+}
+
+// Scale the integer sums back to degrees / percent
+static cr_error_t acc_finish(const stats_acc_t* acc, agg_stats_t* out){
+    if(acc->count == 0) return CR_ERROR_NOT_FOUND;
+
+    double n = (double)acc->count;
+    double temp_mean = (double)acc->temp_sum / n;
+    double hum_mean = (double)acc->hum_sum / n;
+    double temp_var = (double)acc->temp_sumsq / n - temp_mean * temp_mean;
+    double hum_var = (double)acc->hum_sumsq / n - hum_mean * hum_mean;
+
+    out->count = acc->count;
+    out->temp_mean = (float)(temp_mean / CR_TEMP_SCALE);
+    out->temp_min = (float)acc->temp_min / CR_TEMP_SCALE;
+    out->temp_max = (float)acc->temp_max / CR_TEMP_SCALE;
+    out->temp_stddev = (float)(sqrt(temp_var > 0.0 ? temp_var : 0.0) / CR_TEMP_SCALE);
+    out->hum_mean = (float)(hum_mean / CR_HUM_SCALE);
+    out->hum_min = (float)acc->hum_min / CR_HUM_SCALE;
+    out->hum_max = (float)acc->hum_max / CR_HUM_SCALE;
+    out->hum_stddev = (float)(sqrt(hum_var > 0.0 ? hum_var : 0.0) / CR_HUM_SCALE);
+    return CR_SUCCESS;
+}
+
+//============================== cr_array_stats =============================
+// Stats of one sensor over a plain array of compact readings
+cr_error_t cr_array_stats(const compact_reading_t* readings, size_t n, uint8_t sensor_id, agg_stats_t* out_stats){
+
+    if((readings == NULL) || (out_stats == NULL)) return CR_ERROR_NULL;
+
+    stats_acc_t acc;
+    acc_init(&acc);
+    acc_scan(&acc, readings, n, sensor_id);
+    return acc_finish(&acc, out_stats);
+}
+
+//============================== crb_get_stats =============================
+// Stats of one sensor over everything currently in the buffer
+cr_error_t crb_get_stats(const compact_buffer_t* cb, uint8_t sensor_id, agg_stats_t* out_stats){
+
+    if((cb == NULL) || (out_stats == NULL)) return CR_ERROR_NULL;
+
+    // The stored readings are at most two contiguous runs: tail .. end, then 0 .. head
+    size_t first_run = cb->capacity - cb->tail;
+    if(first_run > cb->count) first_run = cb->count;
+
+    stats_acc_t acc;
+    acc_init(&acc);
+    acc_scan(&acc, &cb->buffer[cb->tail], first_run, sensor_id);
+    acc_scan(&acc, &cb->buffer[0], cb->count - first_run, sensor_id);
+    return acc_finish(&acc, out_stats);
+}
@@ -0,0 +1,140 @@
+// compact_reading.h
+// Header file for the compact reading type: struct definitions + function prototypes
+// An optional 8-byte encoding of sensor_data_t for high-density buffers:
+// fixed-point temperature/humidity and a timestamp stored as a delta to the
+// previous reading. Conversion is lossless within the tolerances below.
+
+#ifndef COMPACT_READING_H
+#define COMPACT_READING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "../sensor_data_project/sensor_data.h"
+#include "../window_aggregator_project/window_aggregator.h" // agg_stats_t (header only)
+
+// Fixed-point scales: values are stored as round(value * scale)
+#define CR_TEMP_SCALE 100         // centi-degrees C in int16 -> -327.68 .. 327.67 C
+#define CR_HUM_SCALE 100          // centi-percent in uint16  -> 0 .. 655.35 %
+
+#define CR_TEMP_MIN -327.68f
+#define CR_TEMP_MAX 327.67f
+#define CR_HUM_MAX 655.35f
+
+// Timestamp delta unit. 16 bits of 1 ms cover gaps up to ~65.5 s between
+// consecutive readings; a smaller unit gives finer timestamps but a shorter range.
+// Larger gaps (or a clock that jumps back) are bridged by a rebase record.
+#define CR_TS_UNIT_US 1000u
+#define CR_TS_DELTA_MAX 0xFFFEu
+#define CR_TS_REBASE 0xFFFFu      // ts_delta value that marks a rebase record
+
+/*
+Round-trip tolerance (compact -> sensor_data_t vs the original):
+- temperature: half a step = 0.005 C
+- humidity:    half a step = 0.005 %
+- timestamp:   half a unit = 500 us (errors do not add up, see cr_pack)
+- sensor_id, status: exact
+*/
+#define CR_TEMP_TOLERANCE (0.5f / CR_TEMP_SCALE)
+#define CR_HUM_TOLERANCE (0.5f / CR_HUM_SCALE)
+#define CR_TS_TOLERANCE_US (CR_TS_UNIT_US / 2)
+
+// Capacity of the compact circular buffer (4096 * 8 B = 32 KB)
+#define CR_BUFFER_SIZE 4096
+
+//================================= Struct Definitions ==============================//
+/*
+Compact reading: 8 bytes, 8 readings per 64-byte cache line
+(sensor_data_t is 16 bytes with padding -> 4 per line, node adds a pointer -> 24 bytes, 2 whole nodes per line).
+
+Byte layout (no padding):
+[ temp_centi (2) | hum_centi (2) | ts_delta (2) | sensor_id (1) | status (1) ]
+
+Rebase record (ts_delta == CR_TS_REBASE): not a reading, it restarts the delta
+chain. The absolute 32-bit timestamp is stored in hum_centi (low 16 bits),
+sensor_id and status (high 16 bits); the next reading's delta is relative to it.
+*/
+typedef struct {
+    int16_t temp_centi;   // temperature in 0.01 C
+    uint16_t hum_centi;   // humidity in 0.01 %
+    uint16_t ts_delta;    // time since the previous reading, in CR_TS_UNIT_US
+    uint8_t sensor_id;
+    uint8_t status;       // same bitfield as sensor_data_t
+} compact_reading_t;
+
+// Circular buffer of compact readings, same behaviour as circular_buffer_t.
+// Absolute timestamps are kept for the oldest and newest reading only;
+// every other timestamp is rebuilt by adding deltas. A reading whose gap does not
+// fit 16 bits is stored after a rebase record, so it takes two slots.
+typedef struct {
+    compact_reading_t buffer[CR_BUFFER_SIZE]; // Array to store compact readings
+    size_t head;        // Index for the next write (enqueue)
+    size_t tail;        // Index for the next read (dequeue)
+    size_t count;       // Number of slots in use (readings + rebase records)
+    size_t rebases;     // Rebase records among them
+    size_t capacity;    // Maximum number of items (CR_BUFFER_SIZE)
+    uint32_t tail_ts;   // timestamp of the oldest reading (at tail)
+    uint32_t head_ts;   // timestamp of the newest reading (before head)
+} compact_buffer_t;
+
+//================================= Error Codes ==============================//
+typedef enum {
+    CR_SUCCESS,         // Operation succeeded
+    CR_ERROR_FULL,      // Buffer is full (or has one slot left and the reading needs a rebase)
+    CR_ERROR_EMPTY,     // Buffer is empty, cannot dequeue
+    CR_ERROR_NULL,      // Provided pointer is NULL
+    CR_ERROR_RANGE,     // Value (or, for cr_pack, the time gap) does not fit the compact encoding
+    CR_ERROR_NOT_FOUND  // No readings for this sensor_id
+} cr_error_t;
+
+//================================= Function Prototypes =======================//
+// Convert one reading. 'prev_ts' is the timestamp the delta is relative to
+// (the previous reading's timestamp as rebuilt by the decoder).
+// 'out_ts' receives the timestamp the decoder will rebuild for this reading;
+// pass it as 'prev_ts' of the next reading.
+// CR_ERROR_RANGE if the gap does not fit: write cr_pack_rebase(in->timestamp)
+// first, then pack the reading with prev_ts = in->timestamp.
+cr_error_t cr_pack(const sensor_data_t* in, uint32_t prev_ts, compact_reading_t* out, uint32_t* out_ts);
+cr_error_t cr_unpack(const compact_reading_t* in, uint32_t prev_ts, sensor_data_t* out); // CR_ERROR_RANGE for a rebase record
+
+// Rebase records
+void cr_pack_rebase(uint32_t timestamp, compact_reading_t* out);
+static inline bool cr_is_rebase(const compact_reading_t* r){
+    return r->ts_delta == CR_TS_REBASE;
+}
+static inline uint32_t cr_rebase_timestamp(const compact_reading_t* r){
+    return (uint32_t)r->hum_centi | ((uint32_t)r->sensor_id << 16) | ((uint32_t)r->status << 24);
+}
+
+// Field access without a full unpack
+static inline float cr_temperature(const compact_reading_t* r){
+    return (float)r->temp_centi / CR_TEMP_SCALE;
+}
+static inline float cr_humidity(const compact_reading_t* r){
+    return (float)r->hum_centi / CR_HUM_SCALE;
+}
+
+// Initialize the compact buffer
+void crb_init(compact_buffer_t* cb);
+
+// Core operations, taking and returning sensor_data_t (converted at the boundary)
+cr_error_t crb_enqueue(compact_buffer_t* cb, const sensor_data_t* data);
+cr_error_t crb_enqueue_force(compact_buffer_t* cb, const sensor_data_t* data);
+cr_error_t crb_dequeue(compact_buffer_t* cb, sensor_data_t* out_item);
+cr_error_t crb_peek(const compact_buffer_t* cb, sensor_data_t* out_item);
+
+// Status checks
+bool crb_is_empty(const compact_buffer_t* cb);
+bool crb_is_full(const compact_buffer_t* cb);
+size_t crb_count(const compact_buffer_t* cb);   // readings, not counting rebase records
+
+// Print all items currently in the buffer (same format as cb_print_all)
+void crb_print_all(const compact_buffer_t* cb);
+
+// Aggregation: mean/min/max/stddev of one sensor's readings, computed in
+// integer fixed point (exact sums, no float drift), same result type as the window aggregator.
+// Rebase records are skipped.
+cr_error_t cr_array_stats(const compact_reading_t* readings, size_t n, uint8_t sensor_id, agg_stats_t* out_stats);
+cr_error_t crb_get_stats(const compact_buffer_t* cb, uint8_t sensor_id, agg_stats_t* out_stats);
+
+#endif // COMPACT_READING_H
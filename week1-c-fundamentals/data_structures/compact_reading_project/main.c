@@ -0,0 +1,207 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "compact_reading.h"
+#include "../linked_list_project/linked_list.h"   // only for sizeof(node)
+#include "../../timing/mono_clock_project/mono_clock.h"
+
+#define CACHE_LINE 64
+#define L2_BYTES (256 * 1024)       // typical per-core L2
+#define ROUND_TRIP_READINGS 1000000
+#define SMALL_SCAN (16 * 1024)      // fits in L2 in both layouts
+#define LARGE_SCAN (4u << 20)       // ~4M readings: 64 MB vs 32 MB, memory bound
+#define SCAN_IDS 8                  // readings spread over sensor ids 0..7
+
+
+// Small fast random generator (xorshift)
+static uint32_t rng_state = 2463534242u;
+static uint32_t next_random(void){
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// Random reading: -40 .. 85 C, 0 .. 100 %, any 5-decimal value (not just multiples of 0.01)
+static sensor_data_t random_reading(uint32_t timestamp){
+    uint32_t r = next_random();
+    sensor_data_t s = create_sensor_data(-40.0f + (float)(r % 12500000) / 100000.0f,
+                                         (float)(next_random() % 10000000) / 100000.0f,
+                                         (uint8_t)(r % SCAN_IDS));
+    s.timestamp = timestamp;
+    s.status = (uint8_t)((r >> 24) & 0x1F);
+    return s;
+}
+
+// Reference aggregation over sensor_data_t, as a consumer would write it today
+static void sensor_array_stats(const sensor_data_t* readings, size_t n, uint8_t sensor_id, agg_stats_t* out){
+    size_t count = 0;
+    double temp_sum = 0, temp_sumsq = 0, hum_sum = 0, hum_sumsq = 0;
+    float temp_min = INFINITY, temp_max = -INFINITY, hum_min = INFINITY, hum_max = -INFINITY;
+
+    for(size_t i = 0; i < n; i++){
+        const sensor_data_t* r = &readings[i];
+        if(r->sensor_id != sensor_id) continue;
+        count++;
+        temp_sum += r->temperature;
+        temp_sumsq += (double)r->temperature * r->temperature;
+        hum_sum += r->humidity;
+        hum_sumsq += (double)r->humidity * r->humidity;
+        if(r->temperature < temp_min) temp_min = r->temperature;
+        if(r->temperature > temp_max) temp_max = r->temperature;
+        if(r->humidity < hum_min) hum_min = r->humidity;
+        if(r->humidity > hum_max) hum_max = r->humidity;
+    }
+
+    double temp_mean = temp_sum / count, hum_mean = hum_sum / count;
+    out->count = count;
+    out->temp_mean = (float)temp_mean;
+    out->temp_min = temp_min;
+    out->temp_max = temp_max;
+    out->temp_stddev = (float)sqrt(fmax(temp_sumsq / count - temp_mean * temp_mean, 0.0));
+    out->hum_mean = (float)hum_mean;
+    out->hum_min = hum_min;
+    out->hum_max = hum_max;
+    out->hum_stddev = (float)sqrt(fmax(hum_sumsq / count - hum_mean * hum_mean, 0.0));
+}
+
+// Pack a long stream with random gaps and check every field against the tolerances
+static void check_round_trip(void){
+    float temp_err = 0, hum_err = 0;
+    uint32_t ts_err = 0;
+    size_t other_err = 0;
+
+    uint32_t original_ts = 0xFFF00000u; // start close to the 32-bit wrap on purpose
+    uint32_t prev_ts = original_ts;     // timestamp as rebuilt by the decoder
+
+    for(size_t i = 0; i < ROUND_TRIP_READINGS; i++){
+        original_ts += next_random() % 10000000u; // 0 .. 10 s gap, in us
+        sensor_data_t in = random_reading(original_ts);
+
+        compact_reading_t c;
+        sensor_data_t out;
+        if(cr_pack(&in, prev_ts, &c, &prev_ts) != CR_SUCCESS){
+            printf("  pack failed at reading %zu\n", i);
+            return;
+        }
+        cr_unpack(&c, prev_ts - (uint32_t)c.ts_delta * CR_TS_UNIT_US, &out);
+
+        temp_err = fmaxf(temp_err, fabsf(out.temperature - in.temperature));
+        hum_err = fmaxf(hum_err, fabsf(out.humidity - in.humidity));
+        uint32_t d = (out.timestamp > in.timestamp) ? out.timestamp - in.timestamp : in.timestamp - out.timestamp;
+        if(d > ts_err) ts_err = d;
+        if((out.sensor_id != in.sensor_id) || (out.status != in.status)) other_err++;
+    }
+
+    printf("Round trip of %d readings (gaps 0..10 s, across the 32-bit wrap):\n", ROUND_TRIP_READINGS);
+    printf("  max temp error %.5f C (tolerance %.3f + float rounding)\n", temp_err, CR_TEMP_TOLERANCE);
+    printf("  max hum error  %.5f %% (tolerance %.3f + float rounding)\n", hum_err, CR_HUM_TOLERANCE);
+    printf("  max timestamp error %u us (tolerance %u)\n", ts_err, CR_TS_TOLERANCE_US);
+    printf("  id/status mismatches: %zu\n", other_err);
+}
+
+// Time one scan function; best of a few runs
+static double best_scan_ns(const void* readings, size_t n, bool compact, agg_stats_t* out){
+    double best = 1e30;
+    for(int rep = 0; rep < 5; rep++){
+        uint64_t start = clk_now_ns();
+        if(compact) cr_array_stats((const compact_reading_t*)readings, n, 1, out);
+        else sensor_array_stats((const sensor_data_t*)readings, n, 1, out);
+        double ns = (double)(clk_now_ns() - start) / n;
+        if(ns < best) best = ns;
+    }
+    return best;
+}
+
+// Stats for one sensor over n readings: sensor_data_t array vs compact array
+static void benchmark_scan(size_t n){
+    sensor_data_t* full = malloc(n * sizeof(sensor_data_t));
+    compact_reading_t* compact = malloc(n * sizeof(compact_reading_t));
+    if((full == NULL) || (compact == NULL)){
+        printf("Error: benchmark allocation failed\n");
+        free(full);
+        free(compact);
+        return;
+    }
+
+    uint32_t prev_ts = 0;
+    for(size_t i = 0; i < n; i++){
+        full[i] = random_reading((uint32_t)i * 1000u);
+        cr_pack(&full[i], prev_ts, &compact[i], &prev_ts);
+    }
+
+    agg_stats_t a, b;
+    double full_ns = best_scan_ns(full, n, false, &a);
+    double compact_ns = best_scan_ns(compact, n, true, &b);
+
+    printf("Scan %zu readings (%zu KB vs %zu KB):\n", n,
+           n * sizeof(sensor_data_t) / 1024, n * sizeof(compact_reading_t) / 1024);
+    printf("  sensor_data_t: %.2f ns/reading | compact: %.2f ns/reading | speedup %.2fx\n",
+           full_ns, compact_ns, full_ns / compact_ns);
+    printf("  sensor 1: N=%zu/%zu, mean temp %.4f vs %.4f, max temp %.2f vs %.2f\n",
+           a.count, b.count, a.temp_mean, b.temp_mean, a.temp_max, b.temp_max);
+
+    free(full);
+    free(compact);
+}
+
+
+int main()
+{
+    clk_init(CLK_BACKEND_TSC); // cheaper timestamps for the benchmark; falls back if unavailable
+
+    //============================== Density ==============================
+    printf("Reading density:\n");
+    printf("  node:              %2zu bytes, %zu per cache line, %6zu per 256 KB L2\n",
+           sizeof(node), CACHE_LINE / sizeof(node), L2_BYTES / sizeof(node));
+    printf("  sensor_data_t:     %2zu bytes, %zu per cache line, %6zu per 256 KB L2\n",
+           sizeof(sensor_data_t), CACHE_LINE / sizeof(sensor_data_t), L2_BYTES / sizeof(sensor_data_t));
+    printf("  compact_reading_t: %2zu bytes, %zu per cache line, %6zu per 256 KB L2\n",
+           sizeof(compact_reading_t), CACHE_LINE / sizeof(compact_reading_t), L2_BYTES / sizeof(compact_reading_t));
+    printf("------------------------------------------------------------\n");
+
+    //============================== Buffer demo ==============================
+    static compact_buffer_t cb; // static: 32 KB, keep it off the stack
+    crb_init(&cb);
+
+    sensor_data_t r1 = create_sensor_data(25.5, 40, 1);
+    sensor_data_t r2 = create_sensor_data(27.6, 45, 1);
+    sensor_data_t r3 = create_sensor_data(-3.14159f, 99.999f, 2);
+    r2.timestamp = r1.timestamp + 1500;    // 1.5 ms later
+    r3.timestamp = r2.timestamp + 250000;  // 250 ms later
+    crb_enqueue(&cb, &r1);
+    crb_enqueue(&cb, &r2);
+    crb_enqueue(&cb, &r3);
+    crb_print_all(&cb);
+
+    sensor_data_t too_hot = create_sensor_data(400.0f, 50.0f, 3);
+    printf("Enqueue 400 C -> error code: %d (expected %d = CR_ERROR_RANGE)\n", crb_enqueue(&cb, &too_hot), CR_ERROR_RANGE);
+
+    sensor_data_t late = r3;
+    late.timestamp += 70u * 1000000u; // 70 s gap, more than 16 bits of 1 ms
+    cr_error_t late_err = crb_enqueue(&cb, &late);
+    printf("Enqueue after 70 s gap -> error code: %d (rebase record added: %zu readings in %zu slots)\n",
+           late_err, crb_count(&cb), cb.count);
+
+    agg_stats_t st;
+    if(crb_get_stats(&cb, 1, &st) == CR_SUCCESS){
+        printf("Sensor 1 stats: N=%zu mean %.2f min %.2f max %.2f\n", st.count, st.temp_mean, st.temp_min, st.temp_max);
+    }
+
+    sensor_data_t out;
+    while(crb_dequeue(&cb, &out) == CR_SUCCESS){
+        print_sensor_data(&out);
+    }
+    printf("------------------------------------------------------------\n");
+
+    //============================== Accuracy ==============================
+    check_round_trip();
+    printf("------------------------------------------------------------\n");
+
+    //============================== Scan benchmark ==============================
+    benchmark_scan(SMALL_SCAN);
+    benchmark_scan(LARGE_SCAN);
+    printf("------------------------------------------------------------\n");
+
+    return 0;
+}
@@ -0,0 +1,392 @@
+// Functions implementation
+
+#include "downsample.h"
+#include <string.h>
+#include <math.h>   // for fabs
+
+//================================ bucket helpers ================================
+
+static void bucket_clear(ds_bucket_t* b){
+    b->count = 0;
+    b->temp_min = b->temp_max = 0.0f; // set on the first add
+    b->hum_min = b->hum_max = 0.0f;
+    b->temp_sum = b->hum_sum = 0.0;
+}
+
+static void bucket_add(ds_bucket_t* b, float temp, float hum){
+    if(b->count == 0){
+        b->temp_min = b->temp_max = temp;
+        b->hum_min = b->hum_max = hum;
+    } else {
+        if(temp < b->temp_min) b->temp_min = temp;
+        if(temp > b->temp_max) b->temp_max = temp;
+        if(hum < b->hum_min) b->hum_min = hum;
+        if(hum > b->hum_max) b->hum_max = hum;
+    }
+    b->count++;
+    b->temp_sum += temp;
+    b->hum_sum += hum;
+}
+
+// Merge bucket 'from' into 'into' (rollups are mergeable: min of mins, sum of sums)
+static void bucket_merge(ds_bucket_t* into, const ds_bucket_t* from){
+    if(from->count == 0) return;
+    if(into->count == 0){
+        *into = *from;
+        return;
+    }
+    if(from->temp_min < into->temp_min) into->temp_min = from->temp_min;
+    if(from->temp_max > into->temp_max) into->temp_max = from->temp_max;
+    if(from->hum_min < into->hum_min) into->hum_min = from->hum_min;
+    if(from->hum_max > into->hum_max) into->hum_max = from->hum_max;
+    into->count += from->count;
+    into->temp_sum += from->temp_sum;
+    into->hum_sum += from->hum_sum;
+}
+
+static void bucket_to_rollup(const ds_bucket_t* b, uint64_t start_us, uint64_t width_us, ds_rollup_t* out){
+    out->start_us = start_us;
+    out->width_us = width_us;
+    out->count = b->count;
+    out->temp_min = b->temp_min;
+    out->temp_max = b->temp_max;
+    out->temp_mean = (float)(b->temp_sum / b->count);
+    out->hum_min = b->hum_min;
+    out->hum_max = b->hum_max;
+    out->hum_mean = (float)(b->hum_sum / b->count);
+}
+
+//================================ tier helpers ================================
+
+// Make 'number' the newest bucket: clear the slots between the old newest
+// and it (gaps have no data), and forget buckets that fall out of the ring
+static void tier_advance(ds_tier_t* tier, uint64_t number){
+    uint64_t gap = number - tier->last;
+    if(gap > DS_TIER_CAPACITY) gap = DS_TIER_CAPACITY; // every slot gets cleared anyway
+    for(uint64_t k = number - gap + 1; k <= number; k++){
+        bucket_clear(&tier->buckets[k % DS_TIER_CAPACITY]);
+    }
+
+    tier->last = number;
+    if(number - tier->first >= DS_TIER_CAPACITY) tier->first = number - DS_TIER_CAPACITY + 1;
+    tier->open_start = number * tier->width_us;
+    tier->open_end = tier->open_start + tier->width_us;
+}
+
+// Add one reading at time t_us. Returns false if it is older than the retained range.
+static bool tier_add(ds_tier_t* tier, uint64_t t_us, float temp, float hum){
+    // Fast path: same bucket as the previous reading, no division
+    if(!tier->empty && (t_us >= tier->open_start) && (t_us < tier->open_end)){
+        bucket_add(&tier->buckets[tier->last % DS_TIER_CAPACITY], temp, hum);
+        return true;
+    }
+
+    uint64_t number = t_us / tier->width_us;
+    if(tier->empty){
+        tier->empty = false;
+        tier->first = tier->last = number;
+        bucket_clear(&tier->buckets[number % DS_TIER_CAPACITY]);
+        tier->open_start = number * tier->width_us;
+        tier->open_end = tier->open_start + tier->width_us;
+    } else if(number > tier->last){
+        tier_advance(tier, number);
+    } else if(number < tier->first){
+        tier->dropped++;
+        return false;
+    }
+    // else: a late reading for a bucket that is still retained
+
+    bucket_add(&tier->buckets[number % DS_TIER_CAPACITY], temp, hum);
+    return true;
+}
+
+//================================ ds_init ==============================
+ds_error_t ds_init(ds_series_t* s, uint8_t sensor_id, uint64_t base_width_us, uint32_t factor){
+
+    if(s == NULL) return DS_ERROR_NULL;
+    if((base_width_us == 0) || (factor < 2)) return DS_ERROR_INVALID;
+
+    s->sensor_id = sensor_id;
+    s->now_us = 0;
+    s->last_ts32 = 0;
+    s->clock_us = 0;
+    s->started = false;
+    s->appended = 0;
+
+    uint64_t width = base_width_us;
+    for(size_t k = 0; k < DS_TIERS; k++){
+        ds_tier_t* tier = &s->tiers[k];
+        tier->width_us = width;
+        tier->first = tier->last = 0;
+        tier->open_start = tier->open_end = 0;
+        tier->empty = true;
+        tier->dropped = 0;
+        width *= factor;
+    }
+    return DS_SUCCESS;
+}
+
+//================================ ds_append ==============================
+// 64-bit time of a 32-bit timestamp that is at most 'ahead' after 'ref' and
+// otherwise before it (the 32-bit value repeats every ~71.6 min).
+// Returns false if that would be before time 0.
+static bool unwrap(uint64_t ref, uint32_t ref32, uint32_t ts32, uint64_t ahead, uint64_t* t_us){
+    uint32_t forward = ts32 - ref32;
+    if(forward <= ahead){
+        *t_us = ref + forward;
+        return true;
+    }
+    uint32_t back = ref32 - ts32;
+    if(back > ref) return false;
+    *t_us = ref - back;
+    return true;
+}
+
+// Unwrap the 32-bit timestamp, then update every tier
+static ds_error_t append_one(ds_series_t* s, uint32_t ts32, float temp, float hum){
+    uint64_t t_us;
+    if((s->clock_us != 0) && (!s->started || (s->clock_us > s->now_us))){
+        // The clock says where "now" is, so the gap since the previous reading does not matter
+        if(!unwrap(s->clock_us, (uint32_t)s->clock_us, ts32, DS_MAX_LATE_US, &t_us)) return DS_ERROR_LATE;
+    } else if(!s->started){
+        t_us = ts32;
+    } else {
+        // No clock, or the readings have moved past it: only a small step back is
+        // a late reading; a larger one is a gap that wrapped
+        if(!unwrap(s->now_us, s->last_ts32, ts32, UINT32_MAX - DS_MAX_LATE_US, &t_us)) return DS_ERROR_LATE;
+    }
+    if(!s->started || (t_us > s->now_us)){
+        s->started = true;
+        s->now_us = t_us;
+        s->last_ts32 = ts32;
+    }
+
+    bool kept = false;
+    for(size_t k = 0; k < DS_TIERS; k++){
+        kept |= tier_add(&s->tiers[k], t_us, temp, hum);
+    }
+    if(!kept) return DS_ERROR_LATE;
+
+    s->appended++;
+    return DS_SUCCESS;
+}
+
+ds_error_t ds_append(ds_series_t* s, const sensor_data_t* reading){
+
+    if((s == NULL) || (reading == NULL)) return DS_ERROR_NULL;
+    if(reading->sensor_id != s->sensor_id) return DS_SUCCESS; // not this series
+
+    return append_one(s, reading->timestamp, reading->temperature, reading->humidity);
+}
+
+// Columnar block: only the four columns used here are touched
+ds_error_t ds_append_block(ds_series_t* s, const reading_block_t* block){
+
+    if((s == NULL) || (block == NULL)) return DS_ERROR_NULL;
+
+    ds_error_t result = DS_SUCCESS;
+    for(size_t i = 0; i < block->count; i++){
+        if(block->sensor_id[i] != s->sensor_id) continue;
+        if(append_one(s, block->timestamp[i], block->temperature[i], block->humidity[i]) != DS_SUCCESS){
+            result = DS_ERROR_LATE; // keep going, report that something was dropped
+        }
+    }
+    return result;
+}
+
+//================================ ds_sync ==============================
+ds_error_t ds_sync(ds_series_t* s, uint64_t now_us){
+
+    if(s == NULL) return DS_ERROR_NULL;
+    if(now_us == 0) return DS_ERROR_INVALID; // 0 means "no clock"
+
+    s->clock_us = now_us;
+    return DS_SUCCESS;
+}
+
+//================================ ds_tier_range ==============================
+ds_error_t ds_tier_range(const ds_series_t* s, size_t tier, uint64_t* from_us, uint64_t* to_us){
+
+    if((s == NULL) || (from_us == NULL) || (to_us == NULL)) return DS_ERROR_NULL;
+    if(tier >= DS_TIERS) return DS_ERROR_INVALID;
+
+    const ds_tier_t* t = &s->tiers[tier];
+    if(t->empty) return DS_ERROR_EMPTY;
+    *from_us = t->first * t->width_us;
+    *to_us = (t->last + 1) * t->width_us;
+    return DS_SUCCESS;
+}
+
+//================================ ds_pick_tier ==============================
+static bool tier_covers(const ds_tier_t* t, uint64_t from_us){
+    return !t->empty && (from_us >= t->first * t->width_us);
+}
+
+size_t ds_pick_tier(const ds_series_t* s, uint64_t from_us, uint64_t resolution_us){
+
+    // Coarsest tier that is fine enough
+    size_t pick = 0;
+    for(size_t k = DS_TIERS; k-- > 0; ){
+        if(s->tiers[k].width_us <= resolution_us){
+            pick = k;
+            break;
+        }
+    }
+
+    // Finer tiers keep less history: if the pick does not reach back far enough,
+    // trade resolution for coverage and move to coarser tiers
+    while((pick + 1 < DS_TIERS) && !tier_covers(&s->tiers[pick], from_us)){
+        pick++;
+    }
+    return pick;
+}
+
+//================================ ds_query ==============================
+ds_error_t ds_query(const ds_series_t* s, uint64_t from_us, uint64_t to_us, uint64_t resolution_us,
+                    ds_rollup_t* out, size_t max_out, size_t* out_count, size_t* out_tier){
+
+    if((s == NULL) || (out == NULL) || (out_count == NULL)) return DS_ERROR_NULL;
+    if((to_us <= from_us) || (resolution_us == 0)) return DS_ERROR_INVALID;
+
+    *out_count = 0;
+    size_t k = ds_pick_tier(s, from_us, resolution_us);
+    if(out_tier != NULL) *out_tier = k;
+
+    const ds_tier_t* t = &s->tiers[k];
+    if(t->empty) return DS_ERROR_EMPTY;
+
+    // Output grid: the requested resolution, but never finer than the tier
+    uint64_t step = (resolution_us > t->width_us) ? resolution_us : t->width_us;
+
+    uint64_t b_first = from_us / t->width_us;
+    uint64_t b_last = (to_us - 1) / t->width_us;
+    if(b_first < t->first) b_first = t->first;
+    if(b_last > t->last) b_last = t->last;
+
+    ds_bucket_t acc;
+    bucket_clear(&acc);
+    uint64_t acc_cell = 0;
+
+    for(uint64_t b = b_first; b <= b_last && b_first <= b_last; b++){
+        const ds_bucket_t* bucket = &t->buckets[b % DS_TIER_CAPACITY];
+        if(bucket->count == 0) continue;
+
+        // Buckets are assigned to a grid cell by their start time
+        uint64_t cell = (b * t->width_us) / step;
+        if((acc.count > 0) && (cell != acc_cell)){
+            if(*out_count == max_out) return DS_ERROR_FULL;
+            bucket_to_rollup(&acc, acc_cell * step, step, &out[(*out_count)++]);
+            bucket_clear(&acc);
+        }
+        acc_cell = cell;
+        bucket_merge(&acc, bucket);
+    }
+
+    if(acc.count > 0){
+        if(*out_count == max_out) return DS_ERROR_FULL;
+        bucket_to_rollup(&acc, acc_cell * step, step, &out[(*out_count)++]);
+    }
+    return (*out_count > 0) ? DS_SUCCESS : DS_ERROR_EMPTY;
+}
+
+//================================ ds_lttb ==============================
+/*
+Largest-Triangle-Three-Buckets (Steinarsson, 2013):
+- always keep the first and last point
+- split the rest into threshold - 2 buckets
+- from each bucket keep the point that forms the largest triangle with the
+  point kept from the previous bucket and the average of the next bucket
+*/
+size_t ds_lttb(const ds_point_t* in, size_t n, ds_point_t* out, size_t threshold){
+
+    if((in == NULL) || (out == NULL)) return 0;
+    if(threshold >= n){
+        memcpy(out, in, n * sizeof(ds_point_t)); // nothing to drop
+        return n;
+    }
+    if(threshold < 3){
+        // Not enough room for a middle bucket: keep the end points only
+        if(threshold >= 1) out[0] = in[0];
+        if(threshold == 2) out[1] = in[n - 1];
+        return threshold;
+    }
+
+    double every = (double)(n - 2) / (double)(threshold - 2); // bucket size
+    size_t kept = 0;
+    size_t a = 0;                // index of the last kept point
+    out[kept++] = in[0];
+
+    for(size_t i = 0; i < threshold - 2; i++){
+        // Average of the next bucket (the last point for the final bucket)
+        size_t next_start = (size_t)((i + 1) * every) + 1;
+        size_t next_end = (size_t)((i + 2) * every) + 1;
+        if(next_end > n) next_end = n;
+        double avg_x = 0.0, avg_y = 0.0;
+        for(size_t j = next_start; j < next_end; j++){
+            avg_x += (double)in[j].t_us;
+            avg_y += in[j].value;
+        }
+        size_t next_len = next_end - next_start;
+        if(next_len == 0){
+            avg_x = (double)in[n - 1].t_us;
+            avg_y = in[n - 1].value;
+        } else {
+            avg_x /= (double)next_len;
+            avg_y /= (double)next_len;
+        }
+
+        // Point of the current bucket with the largest triangle
+        size_t start = (size_t)(i * every) + 1;
+        size_t end = (size_t)((i + 1) * every) + 1;
+        double ax = (double)in[a].t_us, ay = in[a].value;
+        double best_area = -1.0;
+        size_t best = start;
+        for(size_t j = start; j < end; j++){
+            double area = fabs((ax - avg_x) * ((double)in[j].value - ay) -
+                               (ax - (double)in[j].t_us) * (avg_y - ay)); // twice the area, enough to compare
+            if(area > best_area){
+                best_area = area;
+                best = j;
+            }
+        }
+
+        out[kept++] = in[best];
+        a = best;
+    }
+
+    out[kept++] = in[n - 1];
+    return kept;
+}
+
+//================================ ds_query_lttb ==============================
+ds_error_t ds_query_lttb(const ds_series_t* s, uint64_t from_us, uint64_t to_us, ds_field_t field,
+                         ds_point_t* out, size_t threshold, size_t* out_count){
+
+    if((s == NULL) || (out == NULL) || (out_count == NULL)) return DS_ERROR_NULL;
+    if(to_us <= from_us) return DS_ERROR_INVALID;
+
+    // Finest detail available for the whole range: resolution 1 us picks tier 0,
+    // ds_pick_tier moves to coarser tiers until the range is covered
+    const ds_tier_t* t = &s->tiers[ds_pick_tier(s, from_us, 1)];
+    if(t->empty) return DS_ERROR_EMPTY;
+
+    uint64_t b_first = from_us / t->width_us;
+    uint64_t b_last = (to_us - 1) / t->width_us;
+    if(b_first < t->first) b_first = t->first;
+    if(b_last > t->last) b_last = t->last;
+
+    // One point per non-empty bucket (its mean at the bucket centre); at most one tier
+    ds_point_t points[DS_TIER_CAPACITY]; // 16 KB
+    size_t n = 0;
+    for(uint64_t b = b_first; b <= b_last && b_first <= b_last; b++){
+        const ds_bucket_t* bucket = &t->buckets[b % DS_TIER_CAPACITY];
+        if(bucket->count == 0) continue;
+        points[n].t_us = b * t->width_us + t->width_us / 2;
+        points[n].value = (float)(((field == DS_FIELD_TEMPERATURE) ? bucket->temp_sum : bucket->hum_sum) / bucket->count);
+        n++;
+    }
+    if(n == 0) return DS_ERROR_EMPTY;
+
+    *out_count = ds_lttb(points, n, out, threshold);
+    return DS_SUCCESS;
+}
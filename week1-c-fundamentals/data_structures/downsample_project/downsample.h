@@ -0,0 +1,142 @@
+// downsample.h
+// Header file for the downsampling engine: struct definitions + function prototypes
+// Keeps time-bucket min/max/mean rollups of one sensor's readings in several
+// resolution tiers, updated as reading blocks are appended. Queries read the
+// coarsest tier that still meets the requested resolution instead of walking
+// every reading; LTTB picks a few representative points for plotting.
+
+#ifndef DOWNSAMPLE_H
+#define DOWNSAMPLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "../sensor_data_project/sensor_data.h"
+#include "../status_filter_project/status_filter.h" // reading_block_t
+
+#define DS_TIERS 4              // resolution tiers per series
+#define DS_TIER_CAPACITY 1024   // buckets kept per tier (older ones are overwritten)
+#define DS_MAX_LATE_US 600000000ull // 10 min: a timestamp further behind the newest one is read as a wrapped gap
+
+/*
+Example with base width 10 s and factor 16:
+ tier 0:    10 s buckets -> last ~2.8 hours
+ tier 1:   160 s buckets -> last ~45 hours
+ tier 2:  2560 s buckets -> last ~30 days
+ tier 3: 40960 s buckets -> last ~16 months
+*/
+
+//================================= Error Codes ==============================//
+typedef enum {
+    DS_SUCCESS,        // Operation succeeded
+    DS_ERROR_NULL,     // Provided pointer is NULL
+    DS_ERROR_INVALID,  // Bad width/factor/range
+    DS_ERROR_EMPTY,    // No readings in the requested range
+    DS_ERROR_FULL,     // Output array too small, result truncated
+    DS_ERROR_LATE      // Reading older than every retained bucket, dropped
+} ds_error_t;
+
+// Which value a point series / LTTB uses
+typedef enum {
+    DS_FIELD_TEMPERATURE,
+    DS_FIELD_HUMIDITY
+} ds_field_t;
+
+//================================= Struct Definitions ==============================//
+// One bucket of a tier. Sums instead of means, so buckets can be merged exactly.
+typedef struct {
+    uint32_t count;                 // readings in the bucket (0 = no data)
+    float temp_min, temp_max;
+    float hum_min, hum_max;
+    double temp_sum, hum_sum;
+} ds_bucket_t;
+
+/*
+One tier: ring of buckets indexed by absolute bucket number
+(bucket number = time / width_us, slot = number % DS_TIER_CAPACITY).
+Buckets first .. last are retained; last is the one still filling.
+Because the slot follows from the time, a late reading still inside the
+retained range is simply added to its old bucket.
+*/
+typedef struct {
+    uint64_t width_us;
+    uint64_t first;                 // oldest retained bucket number
+    uint64_t last;                  // newest bucket number
+    uint64_t open_start, open_end;  // time range of 'last', skips the division on the fast path
+    bool empty;
+    uint64_t dropped;               // readings too old for this tier
+    ds_bucket_t buckets[DS_TIER_CAPACITY];
+} ds_tier_t;
+
+// All tiers of one sensor
+typedef struct {
+    uint8_t sensor_id;
+    ds_tier_t tiers[DS_TIERS];
+    uint64_t now_us;         // newest time seen, 64-bit (the 32-bit timestamps are unwrapped)
+    uint32_t last_ts32;      // raw timestamp behind now_us
+    uint64_t clock_us;       // last ds_sync() time, 0 = none (unwrap from the previous reading)
+    bool started;
+    uint64_t appended;       // readings added
+} ds_series_t;
+
+// Query result: one (possibly merged) bucket
+typedef struct {
+    uint64_t start_us;
+    uint64_t width_us;
+    uint32_t count;
+    float temp_min, temp_mean, temp_max;
+    float hum_min, hum_mean, hum_max;
+} ds_rollup_t;
+
+// Point for LTTB / plotting
+typedef struct {
+    uint64_t t_us;
+    float value;
+} ds_point_t;
+
+//================================= Function Prototypes =======================//
+// Set up tiers: tier k has buckets of base_width_us * factor^k
+ds_error_t ds_init(ds_series_t* s, uint8_t sensor_id, uint64_t base_width_us, uint32_t factor);
+
+/*
+Append readings of this series' sensor, updating every tier: O(DS_TIERS) per reading.
+Timestamps are the 32-bit microsecond values of sensor_data_t, unwrapped to 64 bits:
+- after ds_sync(): against that clock time, so gaps of any length are placed correctly
+- otherwise, or once the readings have moved past the synced time: against the newest
+  reading. Up to DS_MAX_LATE_US behind it is a late reading; anything else is a gap
+  forward, so gaps must stay under ~61 minutes
+Readings from other sensors are skipped.
+*/
+ds_error_t ds_append(ds_series_t* s, const sensor_data_t* reading);
+ds_error_t ds_append_block(ds_series_t* s, const reading_block_t* block);
+
+/*
+Current 64-bit time, from the clock the timestamps come from (clk_now_ns() / 1000
+for readings made by create_sensor_data()). Call it before appending; readings up to
+~61 minutes older (or DS_MAX_LATE_US newer) than now_us are then unwrapped exactly.
+*/
+ds_error_t ds_sync(ds_series_t* s, uint64_t now_us);
+
+// Time range currently retained by tier 'tier'
+ds_error_t ds_tier_range(const ds_series_t* s, size_t tier, uint64_t* from_us, uint64_t* to_us);
+
+// Coarsest tier with width <= resolution_us that still covers from_us.
+// If that tier no longer reaches back to from_us, the finest tier that does is used.
+size_t ds_pick_tier(const ds_series_t* s, uint64_t from_us, uint64_t resolution_us);
+
+/*
+Rollups for [from_us, to_us) with at least the requested resolution: buckets of the
+picked tier merged onto a resolution_us grid (empty buckets skipped).
+*/
+ds_error_t ds_query(const ds_series_t* s, uint64_t from_us, uint64_t to_us, uint64_t resolution_us,
+                    ds_rollup_t* out, size_t max_out, size_t* out_count, size_t* out_tier);
+
+// Largest-Triangle-Three-Buckets: keep 'threshold' of 'n' points that preserve the shape
+// (peaks and dips survive, unlike averaging). Returns the number of points written.
+size_t ds_lttb(const ds_point_t* in, size_t n, ds_point_t* out, size_t threshold);
+
+// LTTB over the bucket means of the finest tier that covers [from_us, to_us)
+ds_error_t ds_query_lttb(const ds_series_t* s, uint64_t from_us, uint64_t to_us, ds_field_t field,
+                         ds_point_t* out, size_t threshold, size_t* out_count);
+
+#endif // DOWNSAMPLE_H
@@ -0,0 +1,206 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "downsample.h"
+#include "../../timing/mono_clock_project/mono_clock.h"
+
+#define DAYS 30
+#define INTERVAL_US 10000000u                        // one reading every 10 s per sensor
+#define READINGS_PER_SENSOR (DAYS * 24u * 360u)      // 259200
+#define SENSORS 2                                    // ids 1 and 2, interleaved in the blocks
+#define HOUR_US 3600000000ull
+#define DAY_US (24 * HOUR_US)
+#define SPIKE_INDEX (READINGS_PER_SENSOR - 300)      // one bad reading ~50 min before the end
+#define RAW_TAIL 1000                                // raw readings used for the LTTB demo
+#define TWO_PI 6.283185307179586                     // M_PI is not in strict C11
+
+
+// Daily temperature cycle with a little noise, plus one spike
+static float temperature_at(uint32_t i){
+    double day_fraction = (double)(i % 8640u) / 8640.0;
+    float t = 20.0f + 6.0f * (float)sin(TWO_PI * day_fraction) + (float)((i * 2654435761u) >> 28) / 16.0f;
+    if(i == SPIKE_INDEX) t += 15.0f;
+    return t;
+}
+
+// Walk every raw reading, the way a chart had to be built without the tiers,
+// and roll up one sensor into 1-hour buckets over [from_us, to_us)
+static size_t naive_hourly(const sensor_data_t* raw, size_t n, uint64_t start_us, uint64_t from_us, uint64_t to_us,
+                           ds_rollup_t* out, size_t max_out){
+    size_t count = 0;
+    uint64_t t_us = start_us;
+    uint32_t last = raw[0].timestamp;
+    for(size_t i = 0; i < n; i++){
+        t_us += (uint32_t)(raw[i].timestamp - last); // unwrap the 32-bit timestamp
+        last = raw[i].timestamp;
+        if((t_us < from_us) || (t_us >= to_us)) continue;
+
+        uint64_t start = t_us / HOUR_US * HOUR_US;
+        if((count == 0) || (out[count - 1].start_us != start)){
+            if(count == max_out) break;
+            ds_rollup_t* r = &out[count++];
+            r->start_us = start;
+            r->width_us = HOUR_US;
+            r->count = 0;
+            r->temp_min = r->temp_max = raw[i].temperature;
+            r->temp_mean = 0.0f;
+        }
+        ds_rollup_t* r = &out[count - 1];
+        r->count++;
+        r->temp_mean += raw[i].temperature; // sum for now
+        if(raw[i].temperature < r->temp_min) r->temp_min = raw[i].temperature;
+        if(raw[i].temperature > r->temp_max) r->temp_max = raw[i].temperature;
+    }
+    for(size_t i = 0; i < count; i++) out[i].temp_mean /= (float)out[i].count;
+    return count;
+}
+
+static void print_query(const char* label, const ds_series_t* s, uint64_t from_us, uint64_t to_us, uint64_t resolution_us){
+    static ds_rollup_t rollups[4096];
+    size_t n = 0, tier = 0;
+    ds_error_t err = ds_query(s, from_us, to_us, resolution_us, rollups, 4096, &n, &tier);
+    printf("%-28s tier %zu (%6.0f s buckets) -> %4zu points (err %d)", label, tier,
+           s->tiers[tier].width_us / 1e6, n, err);
+    if(n > 0){
+        printf(" | first: N=%u temp %.2f/%.2f/%.2f", rollups[0].count,
+               rollups[0].temp_min, rollups[0].temp_mean, rollups[0].temp_max);
+    }
+    printf("\n");
+}
+
+
+int main()
+{
+    clk_init(CLK_BACKEND_TSC);
+
+    static ds_series_t series[SENSORS];          // static: ~160 KB each
+    for(size_t k = 0; k < SENSORS; k++){
+        ds_init(&series[k], (uint8_t)(k + 1), 10000000ull, 16);  // 10 s, 160 s, ~43 min, ~11 h
+    }
+
+    sensor_data_t* raw = malloc(READINGS_PER_SENSOR * sizeof(sensor_data_t));  // sensor 1, for the naive walk
+    static reading_block_t block;
+    sensor_data_t batch[FILTER_BLOCK_SIZE];
+    if(raw == NULL){
+        printf("Error: allocation failed\n");
+        return 1;
+    }
+
+    //============================== Ingest ==============================
+    // 30 days of two sensors, starting just before the 32-bit timestamp wraps
+    uint32_t ts = 0xF0000000u;
+    size_t filled = 0;
+    uint64_t append_ns = 0;
+    for(uint32_t i = 0; i < READINGS_PER_SENSOR; i++){
+        for(uint8_t id = 1; id <= SENSORS; id++){
+            sensor_data_t r = create_sensor_data(temperature_at(i) + (id - 1), 55.0f - (temperature_at(i) - 20.0f), id);
+            r.timestamp = ts;
+            if(id == 1) raw[i] = r;
+            batch[filled++] = r;
+        }
+        ts += INTERVAL_US;
+
+        if((filled == FILTER_BLOCK_SIZE) || (i == READINGS_PER_SENSOR - 1)){
+            filter_load_block(&block, batch, filled);
+            uint64_t start = clk_now_ns();
+            for(size_t k = 0; k < SENSORS; k++) ds_append_block(&series[k], &block);
+            append_ns += clk_now_ns() - start;
+            filled = 0;
+        }
+    }
+    printf("Appended %u readings per sensor for %d sensors: %.1f ns per reading (all %d tiers updated)\n",
+           READINGS_PER_SENSOR, SENSORS, (double)append_ns / (READINGS_PER_SENSOR * SENSORS), DS_TIERS);
+
+    const ds_series_t* s = &series[0];
+    for(size_t k = 0; k < DS_TIERS; k++){
+        uint64_t from, to;
+        if(ds_tier_range(s, k, &from, &to) == DS_SUCCESS){
+            printf("  tier %zu: %6.0f s buckets, covers %7.2f days\n", k, s->tiers[k].width_us / 1e6, (to - from) / (double)DAY_US);
+        }
+    }
+    printf("------------------------------------------------------------\n");
+
+    //============================== Queries ==============================
+    uint64_t end = s->now_us + 1;
+    print_query("last 1 h at 1 min:", s, end - HOUR_US, end, 60000000ull);
+    print_query("last 24 h at 5 min:", s, end - DAY_US, end, 300000000ull);
+    print_query("last 7 days at 1 h:", s, end - 7 * DAY_US, end, HOUR_US);
+    print_query("last 30 days, 2000 points:", s, end - DAYS * DAY_US, end, DAYS * DAY_US / 2000);
+    printf("------------------------------------------------------------\n");
+
+    //============================== Tier query vs walking every reading ==============================
+    static ds_rollup_t fast[256], slow[256];
+    size_t n_fast = 0, n_slow = 0, tier = 0;
+    uint64_t from = end - 7 * DAY_US;
+
+    uint64_t t0 = clk_now_ns();
+    ds_query(s, from, end, HOUR_US, fast, 256, &n_fast, &tier);
+    uint64_t t1 = clk_now_ns();
+    n_slow = naive_hourly(raw, READINGS_PER_SENSOR, s->now_us - (uint64_t)(READINGS_PER_SENSOR - 1) * INTERVAL_US,
+                          from / HOUR_US * HOUR_US, end, slow, 256);
+    uint64_t t2 = clk_now_ns();
+
+    // The hourly grid lines up with ~43 min tier buckets only approximately, so compare the overall max
+    float fast_max = -1e9f, slow_max = -1e9f;
+    for(size_t i = 0; i < n_fast; i++) fast_max = fmaxf(fast_max, fast[i].temp_max);
+    for(size_t i = 0; i < n_slow; i++) slow_max = fmaxf(slow_max, slow[i].temp_max);
+    printf("7 days hourly: tier query %.1f us (%zu points) vs walking %u readings %.1f us (%zu points)\n",
+           (t1 - t0) / 1e3, n_fast, READINGS_PER_SENSOR, (t2 - t1) / 1e3, n_slow);
+    printf("  max temperature: %.2f vs %.2f (spike kept by the max rollup)\n", fast_max, slow_max);
+    printf("------------------------------------------------------------\n");
+
+    //============================== LTTB ==============================
+    // Raw last RAW_TAIL readings -> 50 points: LTTB vs plain averaging
+    static ds_point_t points[RAW_TAIL], kept[RAW_TAIL];
+    for(size_t i = 0; i < RAW_TAIL; i++){
+        size_t src = READINGS_PER_SENSOR - RAW_TAIL + i;
+        points[i].t_us = (uint64_t)src * INTERVAL_US;
+        points[i].value = raw[src].temperature;
+    }
+    size_t n_kept = ds_lttb(points, RAW_TAIL, kept, 50);
+    float lttb_peak = -1e9f, avg_peak = -1e9f, raw_peak = -1e9f;
+    for(size_t i = 0; i < n_kept; i++) lttb_peak = fmaxf(lttb_peak, kept[i].value);
+    for(size_t i = 0; i < RAW_TAIL; i++) raw_peak = fmaxf(raw_peak, points[i].value);
+    for(size_t b = 0; b < 50; b++){
+        float sum = 0.0f;
+        for(size_t i = b * (RAW_TAIL / 50); i < (b + 1) * (RAW_TAIL / 50); i++) sum += points[i].value;
+        avg_peak = fmaxf(avg_peak, sum / (RAW_TAIL / 50));
+    }
+    printf("LTTB %d -> %zu points: peak %.2f (raw peak %.2f, 50 averaged buckets peak %.2f)\n",
+           RAW_TAIL, n_kept, lttb_peak, raw_peak, avg_peak);
+
+    // Whole history for a chart: LTTB over the finest tier that covers it
+    static ds_point_t chart[300];
+    size_t n_chart = 0;
+    ds_error_t err = ds_query_lttb(s, end - DAYS * DAY_US, end, DS_FIELD_TEMPERATURE, chart, 300, &n_chart);
+    printf("LTTB 30 days -> %zu chart points (err %d)\n", n_chart, err);
+    printf("------------------------------------------------------------\n");
+
+    //============================== Long gaps ==============================
+    // 50 min of silence: the 32-bit step alone would look like a reading ~21 min late
+    static ds_series_t quiet;
+    ds_init(&quiet, 3, 10000000ull, 16);
+    sensor_data_t r = create_sensor_data(21.0f, 50.0f, 3);
+    ds_append(&quiet, &r);
+    uint64_t before = quiet.now_us;
+    r.timestamp += 50u * 60u * 1000000u;
+    ds_append(&quiet, &r);
+    printf("50 min gap without a clock: now moved %.1f min\n", (quiet.now_us - before) / 6e7);
+
+    // 5 hours of silence, more than one 32-bit wrap: only the clock can place it
+    uint64_t clock_us = clk_now_ns() / 1000;
+    ds_init(&quiet, 3, 10000000ull, 16);
+    ds_sync(&quiet, clock_us);
+    r.timestamp = (uint32_t)clock_us;
+    ds_append(&quiet, &r);
+    before = quiet.now_us;
+    clock_us += 5 * HOUR_US;
+    r.timestamp = (uint32_t)clock_us;
+    ds_sync(&quiet, clock_us);
+    ds_append(&quiet, &r);
+    printf("5 h gap with ds_sync():     now moved %.1f min\n", (quiet.now_us - before) / 6e7);
+    printf("------------------------------------------------------------\n");
+
+    free(raw);
+    return 0;
+}
@@ -1,13 +1,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "linked_list.h"
+#include "../../timing/mono_clock_project/mono_clock.h" // shared monotonic clock
+#include "../../timing/trace_project/trace.h" // TRACE_SCOPE: compiled out unless -DUSE_TRACE
+#ifdef USE_ASYNC_LOG
+#include "../../concurrency/async_log_project/async_log.h" // background writer instead of printf
+#endif
 
 // Main Objective: store multiple sensor readings in a linked list
 
 
-// Static counter simulating timestamps since we dont have a real hardware clock yet
-// Each new node gets an incremented value, ensuring unique, increasing "timestamps"
-static uint32_t timestamp_counter = 0;
+// Last timestamp handed out. Timestamps come from the monotonic clock (microseconds),
+// but they are also the key for find/delete, so two nodes added within the same
+// microsecond must not get the same value.
+static uint32_t last_timestamp = 0;
 
 //================================================================//
 /*
@@ -47,6 +53,7 @@ add_sensor_reading(&list1, 22.5, 50.0, 1);
 add_sensor_reading(&list2, 23.0, 55.0, 2);
 */
 sensor_status_t add_sensor_reading(node** head, float temp, float hum, uint8_t id){
+    TRACE_SCOPE(TRACE_LIST_INSERT);
     node* new_node = malloc(sizeof(node)); // dynamic memory allocation in heap
     node* current; // temporary pointer to traverse the list
 
@@ -55,7 +62,12 @@ sensor_status_t add_sensor_reading(node** head, float temp, float hum, uint8_t i
     }
 
     //Fill node with data
-    new_node->timestamp = ++timestamp_counter;
+    uint32_t now = clk_now_ts32();
+    // Same microsecond as the previous node (or behind it after a bump): keep keys unique and increasing.
+    // The signed difference handles the 32-bit wrap.
+    if((last_timestamp != 0) && ((int32_t)(now - last_timestamp) <= 0)) now = last_timestamp + 1;
+    new_node->timestamp = now;
+    last_timestamp = now;
     new_node->temperature = temp;
     new_node->humidity = hum;
     new_node->sensor_id = id;
@@ -76,20 +88,36 @@ sensor_status_t add_sensor_reading(node** head, float temp, float hum, uint8_t i
     return SENSOR_OK; //success
 }
 //================================================================//
+// Print one node (through the async writer when it is running)
+static void print_node(const node* n){
+#ifdef USE_ASYNC_LOG
+    // Falls back to printf if the writer stopped after the check
+    if(alog_is_running() &&
+       (alog_node(n->timestamp, n->temperature, n->humidity, n->sensor_id, n->status) != ALOG_ERROR_STOPPED)){
+        return;
+    }
+#endif
+    printf("Timestamp=%u | Temperature=%.2f | Humidity=%.2f%% | SensorID=%u | Status=%u\n",
+           n->timestamp,
+           n->temperature,
+           n->humidity,
+           n->sensor_id,
+           n->status);
+}
+//================================================================//
 void print_all_readings(node** head){
     node* current = *head; // temporary pointer to traverse the list
     if(*head == NULL){
+#ifdef USE_ASYNC_LOG
+        if(alog_is_running() && (alog_text("Linked List is empty!\n") != ALOG_ERROR_STOPPED)){
+            return;
+        }
+#endif
         printf("Linked List is empty!\n");
         return;  // stop function, nothing to print
     }else{
         while(current != NULL){ // go through all nodes
-            printf("Timestamp=%u | Temperature=%.2f | Humidity=%.2f%% | SensorID=%u | Status=%u\n",
-                   current->timestamp,
-                   current->temperature,
-                   current->humidity,
-                   current->sensor_id,
-                   current->status);
-
+            print_node(current);
             current = current->next; // move to next node
         }
     }
@@ -97,6 +125,7 @@ void print_all_readings(node** head){
 //================================================================//
 // Delete a node from the linked list with a given timestamp value
 sensor_status_t delete_specific_reading(node** head, uint32_t time){
+    TRACE_SCOPE(TRACE_LIST_DELETE);
     // If the list is empty
     if (*head == NULL){
         return SENSOR_ERROR_NOT_FOUND;
@@ -132,6 +161,7 @@ sensor_status_t delete_specific_reading(node** head, uint32_t time){
 //================================================================//
 // Find and print a specific sensor reading by its timestamp
 sensor_status_t find_specific_reading(node** head, uint32_t time){
+    TRACE_SCOPE(TRACE_LIST_FIND);
     // If the list is empty, nothing to search
     if (*head == NULL){
         return SENSOR_ERROR_NOT_FOUND;
@@ -149,12 +179,7 @@ sensor_status_t find_specific_reading(node** head, uint32_t time){
     }
 
     // Print all details of the found node
-    printf("Timestamp=%u | Temperature=%.2f | Humidity=%.2f%% | SensorID=%u | Status=%u\n",
-                   current->timestamp,
-                   current->temperature,
-                   current->humidity,
-                   current->sensor_id,
-                   current->status);
+    print_node(current);
 
     return SENSOR_OK;
 }
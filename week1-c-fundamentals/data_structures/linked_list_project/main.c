@@ -42,8 +42,8 @@ int main()
     }
     print_all_readings(&list2);                // print list2
 
-    // delete secific reading and check for error
-    list2_err = delete_specific_reading(&list2, 3);
+    // delete secific reading (the 2nd node) and check for error
+    list2_err = delete_specific_reading(&list2, list2->next->timestamp);
     if(list2_err != SENSOR_OK){
         printf("Error deleting sensor reading: %d\n", list2_err);
     }
@@ -73,7 +73,7 @@ int main()
 
 
     printf("\nSpecific reading found:\n");
-    list3_err = find_specific_reading(&list3, 5);          // find sepcific reading/node
+    list3_err = find_specific_reading(&list3, list3->timestamp); // find sepcific reading/node (the 1st one)
     if(list3_err != SENSOR_OK){
         printf("Error sensor reading not found: %d\n", list3_err);
     }
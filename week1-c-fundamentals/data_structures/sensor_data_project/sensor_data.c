@@ -2,15 +2,27 @@
 
 #include <stdio.h>        // For printf() function
 #include "sensor_data.h"  // Our own header file
+#include "../../timing/mono_clock_project/mono_clock.h" // shared monotonic clock
+#ifdef USE_ASYNC_LOG
+#include "../../concurrency/async_log_project/async_log.h" // background writer instead of printf
+#endif
 
 // Function to print sensor data to the screen
 void print_sensor_data(const sensor_data_t* data) {
     // 'const' means we won't modify the data
     // '*' means we're using a POINTER to the data (faster than copying)
 
+#ifdef USE_ASYNC_LOG
+    // Queue the raw values, the writer thread formats them.
+    // A full ring is a counted drop; a writer that just stopped falls back to printf.
+    if(alog_is_running() && (alog_sensor(data) != ALOG_ERROR_STOPPED)){
+        return;
+    }
+#endif
+
     printf("=== Sensor Reading ===\n");
     printf("Sensor ID: %u\n", data->sensor_id);       // '->' accesses struct through pointer
-    printf("Timestamp: %lu\n", data->timestamp);      // %lu for unsigned long (uint32_t)
+    printf("Timestamp: %u us\n", data->timestamp);    // %u for uint32_t (microseconds, see mono_clock.h)
     printf("Temperature: %.2f C\n", data->temperature); // %.2f = float with 2 decimal places
     printf("Humidity: %.2f %%\n", data->humidity);      // %% prints a real %
     printf("Status: 0x%02X\n", data->status);         // %02X = hex with 2 digits (padded with 0)
@@ -22,7 +34,7 @@ sensor_data_t create_sensor_data(float temp, float hum, uint8_t id) {
     sensor_data_t new_data;   // Create a new struct variable on the stack
 
     // Initialize each field of the struct
-    new_data.timestamp = 0;   // Set to 0 for now (well add real time later)
+    new_data.timestamp = clk_now_ts32(); // Monotonic time in microseconds (32-bit, wraps every ~71 min)
     new_data.temperature = temp;
     new_data.humidity = hum;
     new_data.sensor_id = id;
@@ -6,6 +6,14 @@
 
 #include <stdint.h>
 
+// Status bits for the 'status' bitfield (0 = no errors)
+#define SENSOR_STATUS_OK           0x00
+#define SENSOR_STATUS_TEMP_FAULT   0x01  // temperature element failed / out of its range
+#define SENSOR_STATUS_HUM_FAULT    0x02  // humidity element failed / out of its range
+#define SENSOR_STATUS_LOW_BATTERY  0x04
+#define SENSOR_STATUS_COMM_ERROR   0x08  // reading arrived with a bad checksum or was retried
+#define SENSOR_STATUS_UNCALIBRATED 0x10
+
 typedef struct {
     uint32_t timestamp;
     float temperature;
@@ -0,0 +1,173 @@
+#define _POSIX_C_SOURCE 200809L // for clock_gettime
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "sensor_router.h"
+
+#define BENCH_READINGS (1u << 22)  // ~4M readings per run
+#define BENCH_BATCH 1024           // readings scattered per call
+#define HOT_IDS 4                  // skewed: most readings come from a few sensors
+#define HOT_PERCENT 80
+
+
+// Monotonic time in nanoseconds
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Small fast random generator (xorshift), rand() would dominate the setup time
+static uint32_t rng_state = 2463534242u;
+static uint32_t next_random(void){
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// Fill 'readings' with sensor ids: uniform over all 256 ids, or skewed towards HOT_IDS
+static void make_readings(sensor_data_t* readings, size_t n, bool skewed){
+    for(size_t i = 0; i < n; i++){
+        uint32_t r = next_random();
+        uint8_t id = (uint8_t)(r >> 8);
+        if(skewed && ((r % 100) < HOT_PERCENT)) id = (uint8_t)(r % HOT_IDS);
+        readings[i] = create_sensor_data(20.0f + (float)(r % 100) / 10.0f, 50.0f, id);
+        readings[i].timestamp = (uint32_t)i;
+    }
+}
+
+// Old approach for comparison: look up, then branch on "subscribed" and "full"
+static void scatter_branchy(sensor_router_t* router, const sensor_data_t* batch, size_t count){
+    for(size_t i = 0; i < count; i++){
+        router_ring_t* ring = router->ring_of[batch[i].sensor_id];
+        if(ring == &router->discard){
+            continue; // nobody wants this sensor
+        }
+        if(ring->head - ring->tail >= ROUTER_RING_CAPACITY){
+            ring->dropped++;
+            continue;
+        }
+        ring->slots[ring->head % ROUTER_RING_CAPACITY] = batch[i];
+        ring->head++;
+    }
+}
+
+// Empty every ring so the next batch has room (consumers keeping up)
+static void drain_all(sensor_router_t* router){
+    for(size_t id = 0; id < ROUTER_MAX_IDS; id++){
+        router_ring_t* ring = router->ring_of[id];
+        if(ring != &router->discard) ring->tail = ring->head;
+    }
+}
+
+// Time scatter of all readings in batches, with either the branch-free or the branchy loop
+static double bench_scatter(sensor_router_t* router, const sensor_data_t* readings, size_t n, bool branchy){
+    uint64_t start = now_ns();
+    for(size_t i = 0; i < n; i += BENCH_BATCH){
+        if(branchy) scatter_branchy(router, &readings[i], BENCH_BATCH);
+        else router_scatter(router, &readings[i], BENCH_BATCH);
+        drain_all(router);
+    }
+    uint64_t elapsed = now_ns() - start;
+    return (double)n * 1e3 / (double)elapsed; // M readings / s
+}
+
+// Consumer for sensor 7: scanning the mixed stream vs reading its own ring
+static void bench_consumer(sensor_router_t* router, const sensor_data_t* readings, size_t n){
+    volatile float sink = 0; // keep the compiler from removing the loops
+    size_t found = 0;
+
+    uint64_t start = now_ns();
+    for(size_t i = 0; i < n; i++){
+        if(readings[i].sensor_id == 7){ sink += readings[i].temperature; found++; }
+    }
+    uint64_t scan_ns = now_ns() - start;
+
+    sensor_data_t out[BENCH_BATCH];
+    size_t popped = 0;
+    uint64_t pop_ns = 0;
+    for(size_t i = 0; i < n; i += BENCH_BATCH){
+        router_scatter(router, &readings[i], BENCH_BATCH);
+
+        start = now_ns();
+        size_t got = router_pop_batch(router, 7, out, BENCH_BATCH);
+        for(size_t k = 0; k < got; k++) sink += out[k].temperature;
+        pop_ns += now_ns() - start;
+        popped += got;
+
+        drain_all(router);
+    }
+    (void)sink;
+
+    printf("  consumer of sensor 7: scan+filter %.2f ms (%zu found) | own ring %.2f ms (%zu popped)\n",
+           scan_ns / 1e6, found, pop_ns / 1e6, popped);
+}
+
+static void run_benchmark(const char* label, bool skewed){
+    sensor_data_t* readings = malloc(BENCH_READINGS * sizeof(sensor_data_t));
+    if(readings == NULL){
+        printf("Error: benchmark allocation failed\n");
+        return;
+    }
+    make_readings(readings, BENCH_READINGS, skewed);
+
+    sensor_router_t router;
+    router_init(&router);
+    for(size_t id = 0; id < ROUTER_MAX_IDS; id += 2){
+        router_subscribe(&router, (uint8_t)id); // half the ids have consumers
+    }
+    router_subscribe(&router, 7);
+
+    printf("%s (%u readings, batch %d):\n", label, BENCH_READINGS, BENCH_BATCH);
+    bench_scatter(&router, readings, BENCH_READINGS, false); // warm-up: touch all rings once
+    printf("  branchy scatter:     %.1f M readings/s\n", bench_scatter(&router, readings, BENCH_READINGS, true));
+    printf("  branch-free scatter: %.1f M readings/s\n", bench_scatter(&router, readings, BENCH_READINGS, false));
+    bench_consumer(&router, readings, BENCH_READINGS);
+
+    router_destroy(&router);
+    free(readings);
+}
+
+
+int main()
+{
+    //============================== Functional demo ==============================
+    printf("Router demo:\n\n");
+
+    sensor_router_t router;
+    router_init(&router);
+    router_subscribe(&router, 1);
+    router_subscribe(&router, 2);
+
+    sensor_data_t batch[5];
+    batch[0] = create_sensor_data(25.5, 40, 1);
+    batch[1] = create_sensor_data(20.0, 70, 2);
+    batch[2] = create_sensor_data(27.6, 45, 1);
+    batch[3] = create_sensor_data(18.0, 30, 3); // nobody subscribed to sensor 3
+    batch[4] = create_sensor_data(28.6, 50, 1);
+    router_scatter(&router, batch, 5);
+
+    printf("Sensor 1 count: %zu | Sensor 2 count: %zu | Unrouted: %u\n",
+           router_count(&router, 1), router_count(&router, 2), router_unrouted(&router));
+
+    printf("\nSensor 1 readings:\n");
+    sensor_data_t out;
+    while(router_pop(&router, 1, &out) == ROUTER_SUCCESS){
+        print_sensor_data(&out);
+    }
+
+    router_error_t err = router_pop(&router, 3, &out);
+    printf("Pop from sensor 3 -> error code: %d (expected %d = ROUTER_ERROR_NOT_SUBSCRIBED)\n", err, ROUTER_ERROR_NOT_SUBSCRIBED);
+
+    router_destroy(&router);
+    printf("------------------------------------------------------------\n");
+
+    //============================== Benchmark ==============================
+    run_benchmark("Uniform ids", false);
+    printf("------------------------------------------------------------\n");
+    run_benchmark("Skewed ids (80% from 4 sensors)", true);
+    printf("------------------------------------------------------------\n");
+
+    return 0;
+}
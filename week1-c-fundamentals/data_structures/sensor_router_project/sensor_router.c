@@ -0,0 +1,153 @@
+// Functions implementation
+
+#include "sensor_router.h"
+#include <stdlib.h> // for malloc/free
+
+#define ROUTER_RING_MASK (ROUTER_RING_CAPACITY - 1)
+
+_Static_assert((ROUTER_RING_CAPACITY & ROUTER_RING_MASK) == 0, "ROUTER_RING_CAPACITY must be a power of two");
+
+//================================ ring_reset ================================
+// Private helper: empty a ring
+static void ring_reset(router_ring_t* ring, uint8_t sensor_id){
+    ring->head = 0;
+    ring->tail = 0;
+    ring->dropped = 0;
+    ring->sensor_id = sensor_id;
+}
+
+//================================ router_init ================================
+// Every id starts pointing at the discard ring
+void router_init(sensor_router_t* router){
+    if(router == NULL) return;
+
+    ring_reset(&router->discard, 0);
+    // head - tail == capacity: the discard ring is always "full",
+    // so everything sent to it goes to the overflow slot
+    router->discard.head = ROUTER_RING_CAPACITY;
+
+    for(size_t id = 0; id < ROUTER_MAX_IDS; id++){
+        router->ring_of[id] = &router->discard;
+    }
+    router->subscribed = 0;
+}
+
+//================================ router_destroy ================================
+// Free all rings, router goes back to "nobody subscribed"
+void router_destroy(sensor_router_t* router){
+    if(router == NULL) return;
+
+    for(size_t id = 0; id < ROUTER_MAX_IDS; id++){
+        if(router->ring_of[id] != &router->discard){
+            free(router->ring_of[id]);
+            router->ring_of[id] = &router->discard;
+        }
+    }
+    router->subscribed = 0;
+}
+
+//================================ router_subscribe ================================
+// Give a sensor_id its own ring. Subscribing twice keeps the existing ring.
+router_error_t router_subscribe(sensor_router_t* router, uint8_t sensor_id){
+    if(router == NULL) return ROUTER_ERROR_NULL;
+    if(router->ring_of[sensor_id] != &router->discard) return ROUTER_SUCCESS; // already subscribed
+
+    router_ring_t* ring = malloc(sizeof(router_ring_t)); // dynamic memory allocation in heap
+    if(ring == NULL) return ROUTER_ERROR_MEMORY;
+
+    ring_reset(ring, sensor_id);
+    router->ring_of[sensor_id] = ring;
+    router->subscribed++;
+    return ROUTER_SUCCESS;
+}
+
+//================================ router_unsubscribe ================================
+// Drop the ring of a sensor_id (unread readings are lost)
+router_error_t router_unsubscribe(sensor_router_t* router, uint8_t sensor_id){
+    if(router == NULL) return ROUTER_ERROR_NULL;
+    if(router->ring_of[sensor_id] == &router->discard) return ROUTER_ERROR_NOT_SUBSCRIBED;
+
+    free(router->ring_of[sensor_id]);
+    router->ring_of[sensor_id] = &router->discard;
+    router->subscribed--;
+    return ROUTER_SUCCESS;
+}
+
+bool router_is_subscribed(const sensor_router_t* router, uint8_t sensor_id){
+    return (router != NULL) && (router->ring_of[sensor_id] != &router->discard);
+}
+
+//================================ router_scatter ================================
+/*
+Scatter a batch of readings into their rings.
+The loop body has no data-dependent branches:
+- the id -> ring lookup always returns a valid ring (discard for unsubscribed ids)
+- "ring full" does not skip the reading, it only changes the slot index to the
+  overflow slot (computed with masks, so the compiler cannot turn it into a jump)
+so the cost stays the same whether ids are uniform, skewed or unsubscribed.
+*/
+void router_scatter(sensor_router_t* router, const sensor_data_t* batch, size_t count){
+    if((router == NULL) || (batch == NULL)) return;
+
+    for(size_t i = 0; i < count; i++){
+        router_ring_t* ring = router->ring_of[batch[i].sensor_id];
+
+        uint32_t head = ring->head;
+        uint32_t full = (uint32_t)((head - ring->tail) >= ROUTER_RING_CAPACITY); // 0 or 1
+
+        // not full: head & mask    full: ROUTER_RING_CAPACITY (overflow slot)
+        uint32_t index = ((head & ROUTER_RING_MASK) & (full - 1u)) + full * ROUTER_RING_CAPACITY;
+        ring->slots[index] = batch[i];
+
+        ring->head = head + (full ^ 1u); // advance only if it was stored
+        ring->dropped += full;
+    }
+}
+
+//================================ router_pop ================================
+// Remove the oldest reading of one sensor
+router_error_t router_pop(sensor_router_t* router, uint8_t sensor_id, sensor_data_t* out_item){
+    if((router == NULL) || (out_item == NULL)) return ROUTER_ERROR_NULL;
+
+    router_ring_t* ring = router->ring_of[sensor_id];
+    if(ring == &router->discard) return ROUTER_ERROR_NOT_SUBSCRIBED;
+    if(ring->head == ring->tail) return ROUTER_ERROR_EMPTY;
+
+    *out_item = ring->slots[ring->tail & ROUTER_RING_MASK];
+    ring->tail++;
+    return ROUTER_SUCCESS;
+}
+
+//================================ router_pop_batch ================================
+// Copy up to 'max_items' readings of one sensor, returns how many were copied
+size_t router_pop_batch(sensor_router_t* router, uint8_t sensor_id, sensor_data_t* out_items, size_t max_items){
+    if((router == NULL) || (out_items == NULL)) return 0;
+
+    router_ring_t* ring = router->ring_of[sensor_id];
+    if(ring == &router->discard) return 0;
+
+    size_t available = ring->head - ring->tail;
+    size_t n = (available < max_items) ? available : max_items;
+
+    for(size_t i = 0; i < n; i++){
+        out_items[i] = ring->slots[(ring->tail + i) & ROUTER_RING_MASK];
+    }
+    ring->tail += (uint32_t)n;
+    return n;
+}
+
+//================================ status checks ================================
+size_t router_count(const sensor_router_t* router, uint8_t sensor_id){
+    if(!router_is_subscribed(router, sensor_id)) return 0;
+    const router_ring_t* ring = router->ring_of[sensor_id];
+    return ring->head - ring->tail;
+}
+
+uint32_t router_dropped(const sensor_router_t* router, uint8_t sensor_id){
+    if(!router_is_subscribed(router, sensor_id)) return 0;
+    return router->ring_of[sensor_id]->dropped;
+}
+
+uint32_t router_unrouted(const sensor_router_t* router){
+    return (router == NULL) ? 0 : router->discard.dropped;
+}
@@ -0,0 +1,86 @@
+// sensor_router.h
+// Header file for the per-sensor_id router: struct definitions + function prototypes
+// Takes batches of mixed readings and scatters them into one ring per sensor_id,
+// so a consumer interested in a single sensor reads only its own ring.
+
+#ifndef SENSOR_ROUTER_H
+#define SENSOR_ROUTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "../sensor_data_project/sensor_data.h"
+
+// One ring per possible sensor_id (uint8_t -> 256 ids)
+#define ROUTER_MAX_IDS 256
+
+// Readings per ring. MUST be a power of two (index = counter & mask)
+#define ROUTER_RING_CAPACITY 1024
+
+//================================= Struct Definitions ==============================//
+/*
+Ring for one sensor_id.
+head/tail are free-running counters: count = head - tail, slot = counter & mask.
+slots[ROUTER_RING_CAPACITY] is an extra scratch slot: when the ring is full the
+reading is written there instead, so the scatter loop never has to branch on "full".
+*/
+typedef struct {
+    uint32_t head;                                // total readings written
+    uint32_t tail;                                // total readings read
+    uint32_t dropped;                             // readings lost because the ring was full
+    uint8_t sensor_id;
+    sensor_data_t slots[ROUTER_RING_CAPACITY + 1]; // +1: overflow slot, written when full (discarded)
+} router_ring_t;
+
+/*
+Router: dense id -> ring table.
+
+    ring_of[0]   -> ring for sensor 0   (subscribed)
+    ring_of[1]   -> &discard            (nobody subscribed)
+    ...
+    ring_of[255] -> ring for sensor 255
+
+Every entry is a valid pointer. Ids without a subscriber point to 'discard',
+a ring that is permanently full, so their readings land in its overflow slot
+and are counted in discard.dropped - again without a branch.
+*/
+typedef struct {
+    router_ring_t* ring_of[ROUTER_MAX_IDS];
+    router_ring_t discard;
+    size_t subscribed;                            // number of ids with their own ring
+} sensor_router_t;
+
+//================================= Error Codes ==============================//
+typedef enum {
+    ROUTER_SUCCESS,          // Operation succeeded
+    ROUTER_ERROR_EMPTY,      // Ring is empty, nothing to pop
+    ROUTER_ERROR_NULL,       // Provided pointer is NULL
+    ROUTER_ERROR_MEMORY,     // malloc failed while subscribing
+    ROUTER_ERROR_NOT_SUBSCRIBED // No ring for this sensor_id
+} router_error_t;
+
+//================================= Function Prototypes =======================//
+// Initialize: no id is subscribed, every reading is discarded
+void router_init(sensor_router_t* router);
+
+// Free every ring
+void router_destroy(sensor_router_t* router);
+
+// Subscriptions: create / remove the ring of one sensor_id
+router_error_t router_subscribe(sensor_router_t* router, uint8_t sensor_id);
+router_error_t router_unsubscribe(sensor_router_t* router, uint8_t sensor_id);
+bool router_is_subscribed(const sensor_router_t* router, uint8_t sensor_id);
+
+// Producer side: scatter a batch of mixed readings into the per-id rings
+void router_scatter(sensor_router_t* router, const sensor_data_t* batch, size_t count);
+
+// Consumer side: read the oldest reading(s) of one sensor
+router_error_t router_pop(sensor_router_t* router, uint8_t sensor_id, sensor_data_t* out_item);
+size_t router_pop_batch(sensor_router_t* router, uint8_t sensor_id, sensor_data_t* out_items, size_t max_items);
+
+// Status checks
+size_t router_count(const sensor_router_t* router, uint8_t sensor_id);
+uint32_t router_dropped(const sensor_router_t* router, uint8_t sensor_id);   // lost because ring full
+uint32_t router_unrouted(const sensor_router_t* router);                     // lost because nobody subscribed
+
+#endif // SENSOR_ROUTER_H
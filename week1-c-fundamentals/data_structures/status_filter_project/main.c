@@ -0,0 +1,170 @@
+#define _POSIX_C_SOURCE 200809L // for clock_gettime
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "status_filter.h"
+
+#define BENCH_BLOCKS 4096   // 4096 * 1024 = ~4M readings
+#define BENCH_REPEAT 5
+
+
+// Monotonic time in nanoseconds
+static uint64_t now_ns(void){
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Small fast random generator (xorshift)
+static uint32_t rng_state = 2463534242u;
+static uint32_t next_random(void){
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+// Random readings: mostly normal, a few percent with faults or out-of-range values
+static void make_readings(sensor_data_t* readings, size_t n){
+    for(size_t i = 0; i < n; i++){
+        uint32_t r = next_random();
+        readings[i] = create_sensor_data(-10.0f + (float)(r % 600) / 10.0f,   // -10 .. 50 C
+                                         (float)((r >> 10) % 1000) / 10.0f,   // 0 .. 100 %
+                                         (uint8_t)(r >> 20));
+        readings[i].timestamp = (uint32_t)i;
+        if((r >> 28) == 0) readings[i].status = (uint8_t)((r >> 8) & 0x1F); // ~6% with status bits
+    }
+}
+
+// Alert rule written the usual way, one reading at a time with branches:
+// (TEMP_FAULT or COMM_ERROR) or temp outside [0, 45] or (humidity >= 90 and sensor in {1, 5, 9})
+static bool alert_if_chain(const sensor_data_t* r){
+    if(r->status & (SENSOR_STATUS_TEMP_FAULT | SENSOR_STATUS_COMM_ERROR)) return true;
+    if((r->temperature < 0.0f) || (r->temperature > 45.0f)) return true;
+    if(r->humidity >= 90.0f){
+        if((r->sensor_id == 1) || (r->sensor_id == 5) || (r->sensor_id == 9)) return true;
+    }
+    return false;
+}
+
+// The same rule compiled into a filter program
+static filter_error_t build_alert_program(filter_program_t* prog){
+    const uint8_t watched[] = {1, 5, 9};
+    filter_error_t err;
+
+    filter_init(prog);
+    if((err = filter_status_any(prog, SENSOR_STATUS_TEMP_FAULT | SENSOR_STATUS_COMM_ERROR)) != FILTER_SUCCESS) return err;
+    if((err = filter_temp_in(prog, 0.0f, 45.0f)) != FILTER_SUCCESS) return err;
+    if((err = filter_not(prog)) != FILTER_SUCCESS) return err;           // folded into TEMP_OUT by compile
+    if((err = filter_or(prog)) != FILTER_SUCCESS) return err;
+    if((err = filter_hum_in(prog, 90.0f, 1000.0f)) != FILTER_SUCCESS) return err;
+    if((err = filter_id_in(prog, watched, 3)) != FILTER_SUCCESS) return err;
+    if((err = filter_and(prog)) != FILTER_SUCCESS) return err;
+    if((err = filter_or(prog)) != FILTER_SUCCESS) return err;
+    return filter_compile(prog);
+}
+
+
+int main()
+{
+    filter_program_t prog;
+    filter_error_t err = build_alert_program(&prog);
+    if(err != FILTER_SUCCESS){
+        printf("Error building filter program, error code: %d\n", err);
+        return 1;
+    }
+    printf("Alert program: %zu instructions after compile\n", prog.length);
+
+    // A program that leaves two results on the stack must be rejected
+    filter_program_t bad;
+    filter_init(&bad);
+    filter_temp_in(&bad, 0, 10);
+    filter_hum_in(&bad, 0, 10);
+    printf("Compile with 2 results -> error code: %d (expected %d = FILTER_ERROR_INVALID)\n",
+           filter_compile(&bad), FILTER_ERROR_INVALID);
+    printf("------------------------------------------------------------\n");
+
+    //============================== Small demo ==============================
+    sensor_data_t demo[5];
+    demo[0] = create_sensor_data(23.5, 45.0, 1);  // normal
+    demo[1] = create_sensor_data(48.0, 40.0, 2);  // too hot
+    demo[2] = create_sensor_data(20.0, 95.0, 5);  // humid on a watched sensor
+    demo[3] = create_sensor_data(20.0, 95.0, 6);  // humid, not watched
+    demo[4] = create_sensor_data(21.0, 50.0, 3);
+    demo[4].status = SENSOR_STATUS_COMM_ERROR;    // fault bit
+
+    static reading_block_t block; // static: ~10 KB, keep it off the stack
+    uint64_t bitmap[FILTER_BITMAP_WORDS];
+    uint16_t indices[FILTER_BLOCK_SIZE];
+
+    filter_load_block(&block, demo, 5);
+    size_t selected = filter_run(&prog, &block, bitmap);
+    size_t n = filter_bitmap_to_indices(bitmap, indices);
+    printf("Demo: %zu of 5 readings selected, indices:", selected);
+    for(size_t i = 0; i < n; i++) printf(" %u", indices[i]);
+    printf(" (expected 1 2 4)\n");
+    printf("------------------------------------------------------------\n");
+
+    //============================== Benchmark ==============================
+    size_t total = (size_t)BENCH_BLOCKS * FILTER_BLOCK_SIZE;
+    sensor_data_t* readings = malloc(total * sizeof(sensor_data_t));
+    reading_block_t* blocks = malloc(BENCH_BLOCKS * sizeof(reading_block_t));
+    if((readings == NULL) || (blocks == NULL)){
+        printf("Error: benchmark allocation failed\n");
+        free(readings);
+        free(blocks);
+        return 1;
+    }
+    make_readings(readings, total);
+
+    // Transposing is a one-time cost if readings are stored in columns from the start
+    uint64_t start = now_ns();
+    for(size_t b = 0; b < BENCH_BLOCKS; b++){
+        filter_load_block(&blocks[b], &readings[b * FILTER_BLOCK_SIZE], FILTER_BLOCK_SIZE);
+    }
+    uint64_t load_ns = now_ns() - start;
+
+    size_t chain_hits = 0, filter_hits = 0;
+    uint64_t chain_ns = UINT64_MAX, filter_ns = UINT64_MAX;  // best of BENCH_REPEAT
+
+    for(int rep = 0; rep < BENCH_REPEAT; rep++){
+        start = now_ns();
+        size_t hits = 0;
+        for(size_t i = 0; i < total; i++){
+            if(alert_if_chain(&readings[i])) indices[hits++ % FILTER_BLOCK_SIZE] = (uint16_t)i;
+        }
+        uint64_t t = now_ns() - start;
+        if(t < chain_ns) chain_ns = t;
+        chain_hits = hits;
+
+        start = now_ns();
+        hits = 0;
+        for(size_t b = 0; b < BENCH_BLOCKS; b++){
+            hits += filter_run(&prog, &blocks[b], bitmap);
+            filter_bitmap_to_indices(bitmap, indices);
+        }
+        t = now_ns() - start;
+        if(t < filter_ns) filter_ns = t;
+        filter_hits = hits;
+    }
+
+    printf("Benchmark: %zu readings\n", total);
+    printf("  if-chain:       %.2f ms (%.2f ns/reading) -> %zu alerts\n",
+           chain_ns / 1e6, (double)chain_ns / total, chain_hits);
+    printf("  filter program: %.2f ms (%.2f ns/reading) -> %zu alerts%s\n",
+           filter_ns / 1e6, (double)filter_ns / total, filter_hits,
+           (chain_hits == filter_hits) ? "" : "  MISMATCH!");
+    printf("  (one-time column transpose: %.2f ms)\n", load_ns / 1e6);
+#if defined(__AVX2__)
+    printf("  SIMD: AVX2\n");
+#elif defined(__SSE2__)
+    printf("  SIMD: SSE2\n");
+#else
+    printf("  SIMD: none (scalar fallback)\n");
+#endif
+    printf("------------------------------------------------------------\n");
+
+    free(blocks);
+    free(readings);
+    return 0;
+}
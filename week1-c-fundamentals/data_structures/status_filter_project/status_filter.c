@@ -0,0 +1,309 @@
+// Functions implementation
+
+#include "status_filter.h"
+#include <string.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+_Static_assert((FILTER_BLOCK_SIZE % 64) == 0, "FILTER_BLOCK_SIZE must be a multiple of 64");
+
+//================================ program building ================================
+
+void filter_init(filter_program_t* prog){
+    if(prog == NULL) return;
+    memset(prog, 0, sizeof(*prog));
+}
+
+// Private helper: append one instruction and track the stack depth.
+// 'pops' operands are consumed, one result is pushed.
+static filter_error_t emit(filter_program_t* prog, filter_instr_t instr, int pops){
+    if(prog == NULL) return FILTER_ERROR_NULL;
+    if(prog->length == FILTER_MAX_INSTR) return FILTER_ERROR_FULL;
+    if(prog->depth < pops) return FILTER_ERROR_STACK;             // e.g. AND with one operand
+    if(prog->depth - pops + 1 > FILTER_MAX_DEPTH) return FILTER_ERROR_STACK;
+
+    prog->code[prog->length++] = instr;
+    prog->depth = prog->depth - pops + 1;
+    prog->compiled = false; // program changed, must be compiled again
+    return FILTER_SUCCESS;
+}
+
+static filter_error_t emit_status(filter_program_t* prog, filter_opcode_t op, uint8_t mask){
+    filter_instr_t instr = { .op = op, .mask = mask };
+    return emit(prog, instr, 0);
+}
+
+static filter_error_t emit_range(filter_program_t* prog, filter_opcode_t op, float lo, float hi){
+    filter_instr_t instr = { .op = op, .lo = lo, .hi = hi };
+    return emit(prog, instr, 0);
+}
+
+filter_error_t filter_status_any(filter_program_t* prog, uint8_t mask){ return emit_status(prog, FILTER_OP_STATUS_ANY, mask); }
+filter_error_t filter_status_all(filter_program_t* prog, uint8_t mask){ return emit_status(prog, FILTER_OP_STATUS_ALL, mask); }
+filter_error_t filter_status_none(filter_program_t* prog, uint8_t mask){ return emit_status(prog, FILTER_OP_STATUS_NONE, mask); }
+filter_error_t filter_temp_in(filter_program_t* prog, float lo, float hi){ return emit_range(prog, FILTER_OP_TEMP_IN, lo, hi); }
+filter_error_t filter_temp_out(filter_program_t* prog, float lo, float hi){ return emit_range(prog, FILTER_OP_TEMP_OUT, lo, hi); }
+filter_error_t filter_hum_in(filter_program_t* prog, float lo, float hi){ return emit_range(prog, FILTER_OP_HUM_IN, lo, hi); }
+filter_error_t filter_hum_out(filter_program_t* prog, float lo, float hi){ return emit_range(prog, FILTER_OP_HUM_OUT, lo, hi); }
+
+// sensor_id set: stored as a 256-bit bitmap so membership is one shift + mask
+filter_error_t filter_id_in(filter_program_t* prog, const uint8_t* ids, size_t id_count){
+    if((prog == NULL) || (ids == NULL)) return FILTER_ERROR_NULL;
+    if(prog->id_set_count == FILTER_MAX_ID_SETS) return FILTER_ERROR_FULL;
+
+    filter_instr_t instr = { .op = FILTER_OP_ID_IN, .set = (uint8_t)prog->id_set_count };
+    filter_error_t err = emit(prog, instr, 0);
+    if(err != FILTER_SUCCESS) return err;
+
+    uint64_t* set = prog->id_sets[prog->id_set_count++];
+    set[0] = set[1] = set[2] = set[3] = 0;
+    for(size_t i = 0; i < id_count; i++){
+        set[ids[i] >> 6] |= 1ull << (ids[i] & 63);
+    }
+    return FILTER_SUCCESS;
+}
+
+filter_error_t filter_and(filter_program_t* prog){
+    filter_instr_t instr = { .op = FILTER_OP_AND };
+    return emit(prog, instr, 2);
+}
+
+filter_error_t filter_or(filter_program_t* prog){
+    filter_instr_t instr = { .op = FILTER_OP_OR };
+    return emit(prog, instr, 2);
+}
+
+filter_error_t filter_not(filter_program_t* prog){
+    filter_instr_t instr = { .op = FILTER_OP_NOT };
+    return emit(prog, instr, 1);
+}
+
+//================================ filter_compile ================================
+/*
+Make the program runnable:
+- it must leave exactly one bitmap on the stack
+- "predicate NOT" is folded into the opposite predicate
+  (TEMP_IN + NOT -> TEMP_OUT, STATUS_ANY + NOT -> STATUS_NONE, ...)
+  which saves one full pass over the bitmap
+*/
+filter_error_t filter_compile(filter_program_t* prog){
+    if(prog == NULL) return FILTER_ERROR_NULL;
+    if(prog->depth != 1) return FILTER_ERROR_INVALID;
+
+    size_t out = 0;
+    for(size_t i = 0; i < prog->length; i++){
+        filter_instr_t instr = prog->code[i];
+
+        if((instr.op == FILTER_OP_NOT) && (out > 0)){
+            filter_instr_t* prev = &prog->code[out - 1];
+            bool folded = true;
+            switch(prev->op){
+                case FILTER_OP_STATUS_ANY:  prev->op = FILTER_OP_STATUS_NONE; break;
+                case FILTER_OP_STATUS_NONE: prev->op = FILTER_OP_STATUS_ANY;  break;
+                case FILTER_OP_TEMP_IN:     prev->op = FILTER_OP_TEMP_OUT;    break;
+                case FILTER_OP_TEMP_OUT:    prev->op = FILTER_OP_TEMP_IN;     break;
+                case FILTER_OP_HUM_IN:      prev->op = FILTER_OP_HUM_OUT;     break;
+                case FILTER_OP_HUM_OUT:     prev->op = FILTER_OP_HUM_IN;      break;
+                default: folded = false; break;
+            }
+            if(folded) continue; // NOT absorbed, don't copy it
+        }
+        prog->code[out++] = instr;
+    }
+    prog->length = out;
+    prog->compiled = true;
+    return FILTER_SUCCESS;
+}
+
+//================================ filter_load_block ================================
+// Transpose readings into columns. Unused tail entries are zeroed.
+size_t filter_load_block(reading_block_t* block, const sensor_data_t* readings, size_t n){
+    if((block == NULL) || (readings == NULL)) return 0;
+    if(n > FILTER_BLOCK_SIZE) n = FILTER_BLOCK_SIZE;
+
+    for(size_t i = 0; i < n; i++){
+        block->temperature[i] = readings[i].temperature;
+        block->humidity[i] = readings[i].humidity;
+        block->timestamp[i] = readings[i].timestamp;
+        block->sensor_id[i] = readings[i].sensor_id;
+        block->status[i] = readings[i].status;
+    }
+    for(size_t i = n; i < FILTER_BLOCK_SIZE; i++){
+        block->temperature[i] = 0.0f;
+        block->humidity[i] = 0.0f;
+        block->timestamp[i] = 0;
+        block->sensor_id[i] = 0;
+        block->status[i] = 0;
+    }
+    block->count = n;
+    return n;
+}
+
+//================================ predicate kernels ================================
+/*
+Each kernel checks 64 readings and returns them as one 64-bit word.
+SIMD versions compare 8 (AVX2) or 4/16 (SSE2) values per instruction and use
+movemask to turn the comparison lanes into bits. The scalar fallback builds the
+bits without branches so it is still fast on other CPUs.
+*/
+
+// lo <= x <= hi for 64 floats (NaN is never inside)
+static uint64_t range_word(const float* x, float lo, float hi){
+    uint64_t bits = 0;
+#if defined(__AVX2__)
+    __m256 vlo = _mm256_set1_ps(lo);
+    __m256 vhi = _mm256_set1_ps(hi);
+    for(int i = 0; i < 64; i += 8){
+        __m256 v = _mm256_loadu_ps(x + i);
+        __m256 m = _mm256_and_ps(_mm256_cmp_ps(v, vlo, _CMP_GE_OQ), _mm256_cmp_ps(v, vhi, _CMP_LE_OQ));
+        bits |= (uint64_t)(uint32_t)_mm256_movemask_ps(m) << i;
+    }
+#elif defined(__SSE2__)
+    __m128 vlo = _mm_set1_ps(lo);
+    __m128 vhi = _mm_set1_ps(hi);
+    for(int i = 0; i < 64; i += 4){
+        __m128 v = _mm_loadu_ps(x + i);
+        __m128 m = _mm_and_ps(_mm_cmpge_ps(v, vlo), _mm_cmple_ps(v, vhi));
+        bits |= (uint64_t)(uint32_t)_mm_movemask_ps(m) << i;
+    }
+#else
+    for(int i = 0; i < 64; i++){
+        bits |= (uint64_t)((x[i] >= lo) & (x[i] <= hi)) << i;
+    }
+#endif
+    return bits;
+}
+
+// (status & mask) == want for 64 status bytes
+static uint64_t status_eq_word(const uint8_t* s, uint8_t mask, uint8_t want){
+    uint64_t bits = 0;
+#if defined(__SSE2__)
+    __m128i vmask = _mm_set1_epi8((char)mask);
+    __m128i vwant = _mm_set1_epi8((char)want);
+    for(int i = 0; i < 64; i += 16){
+        __m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+        __m128i eq = _mm_cmpeq_epi8(_mm_and_si128(v, vmask), vwant);
+        bits |= (uint64_t)(uint32_t)_mm_movemask_epi8(eq) << i;
+    }
+#else
+    for(int i = 0; i < 64; i++){
+        bits |= (uint64_t)((s[i] & mask) == want) << i;
+    }
+#endif
+    return bits;
+}
+
+// sensor_id in set, for 64 ids: bit lookup in the 256-bit set (no SIMD gather, but no branches)
+static uint64_t id_word(const uint8_t* ids, const uint64_t set[4]){
+    uint64_t bits = 0;
+    for(int i = 0; i < 64; i++){
+        bits |= ((set[ids[i] >> 6] >> (ids[i] & 63)) & 1ull) << i;
+    }
+    return bits;
+}
+
+// Fill 'dst' with the result of one predicate. The switch is outside the loop
+// so each case is a tight loop over the words.
+static void eval_predicate(const filter_program_t* prog, const filter_instr_t* in,
+                           const reading_block_t* b, uint64_t* dst, size_t words){
+    size_t w;
+    switch(in->op){
+        case FILTER_OP_STATUS_ANY:
+            for(w = 0; w < words; w++) dst[w] = ~status_eq_word(&b->status[w * 64], in->mask, 0);
+            break;
+        case FILTER_OP_STATUS_ALL:
+            for(w = 0; w < words; w++) dst[w] = status_eq_word(&b->status[w * 64], in->mask, in->mask);
+            break;
+        case FILTER_OP_STATUS_NONE:
+            for(w = 0; w < words; w++) dst[w] = status_eq_word(&b->status[w * 64], in->mask, 0);
+            break;
+        case FILTER_OP_TEMP_IN:
+            for(w = 0; w < words; w++) dst[w] = range_word(&b->temperature[w * 64], in->lo, in->hi);
+            break;
+        case FILTER_OP_TEMP_OUT:
+            for(w = 0; w < words; w++) dst[w] = ~range_word(&b->temperature[w * 64], in->lo, in->hi);
+            break;
+        case FILTER_OP_HUM_IN:
+            for(w = 0; w < words; w++) dst[w] = range_word(&b->humidity[w * 64], in->lo, in->hi);
+            break;
+        case FILTER_OP_HUM_OUT:
+            for(w = 0; w < words; w++) dst[w] = ~range_word(&b->humidity[w * 64], in->lo, in->hi);
+            break;
+        case FILTER_OP_ID_IN:
+            for(w = 0; w < words; w++) dst[w] = id_word(&b->sensor_id[w * 64], prog->id_sets[in->set]);
+            break;
+        default:
+            for(w = 0; w < words; w++) dst[w] = 0;
+            break;
+    }
+}
+
+//================================ filter_run ================================
+// Evaluate the program one instruction at a time over the whole block
+size_t filter_run(const filter_program_t* prog, const reading_block_t* block, uint64_t out_bitmap[FILTER_BITMAP_WORDS]){
+    if((prog == NULL) || (block == NULL) || (out_bitmap == NULL)) return 0;
+    if(!prog->compiled){
+        memset(out_bitmap, 0, FILTER_BITMAP_WORDS * sizeof(uint64_t));
+        return 0;
+    }
+
+    uint64_t stack[FILTER_MAX_DEPTH][FILTER_BITMAP_WORDS];
+    int top = -1;                                  // index of the top bitmap
+    size_t words = (block->count + 63) / 64;       // only evaluate words that hold readings
+
+    for(size_t pc = 0; pc < prog->length; pc++){
+        const filter_instr_t* in = &prog->code[pc];
+
+        switch(in->op){
+            case FILTER_OP_AND:
+                top--;
+                for(size_t w = 0; w < words; w++) stack[top][w] &= stack[top + 1][w];
+                break;
+            case FILTER_OP_OR:
+                top--;
+                for(size_t w = 0; w < words; w++) stack[top][w] |= stack[top + 1][w];
+                break;
+            case FILTER_OP_NOT:
+                for(size_t w = 0; w < words; w++) stack[top][w] = ~stack[top][w];
+                break;
+            default: // predicates push a new bitmap
+                top++;
+                eval_predicate(prog, in, block, stack[top], words);
+                break;
+        }
+    }
+
+    // Copy the result, clearing bits past 'count' (NOT / *_OUT set them for padding)
+    size_t selected = 0;
+    for(size_t w = 0; w < FILTER_BITMAP_WORDS; w++){
+        uint64_t bits = 0;
+        if(w < words){
+            bits = stack[0][w];
+            size_t valid = block->count - w * 64;
+            if(valid < 64) bits &= (1ull << valid) - 1;
+        }
+        out_bitmap[w] = bits;
+        selected += (size_t)__builtin_popcountll(bits);
+    }
+    return selected;
+}
+
+//================================ filter_bitmap_to_indices ================================
+// Walk only the set bits: ctz finds the next selected reading, bits &= bits - 1 clears it
+size_t filter_bitmap_to_indices(const uint64_t bitmap[FILTER_BITMAP_WORDS], uint16_t* out_indices){
+    if((bitmap == NULL) || (out_indices == NULL)) return 0;
+
+    size_t n = 0;
+    for(size_t w = 0; w < FILTER_BITMAP_WORDS; w++){
+        uint64_t bits = bitmap[w];
+        while(bits != 0){
+            out_indices[n++] = (uint16_t)(w * 64 + (size_t)__builtin_ctzll(bits));
+            bits &= bits - 1;
+        }
+    }
+    return n;
+}
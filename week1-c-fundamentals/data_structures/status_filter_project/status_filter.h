@@ -0,0 +1,119 @@
+// status_filter.h
+// Header file for the anomaly filter engine: struct definitions + function prototypes
+// Predicates over status bits, temperature/humidity ranges and sensor_id sets are
+// compiled into a flat program, then evaluated over blocks of readings stored
+// column by column, producing a selection bitmap (1 bit per reading).
+
+#ifndef STATUS_FILTER_H
+#define STATUS_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "../sensor_data_project/sensor_data.h"
+
+// Readings per block. Multiple of 64 (one bitmap word = 64 readings)
+#define FILTER_BLOCK_SIZE 1024
+#define FILTER_BITMAP_WORDS (FILTER_BLOCK_SIZE / 64)
+
+#define FILTER_MAX_INSTR 32    // instructions per program
+#define FILTER_MAX_DEPTH 8     // evaluation stack depth
+#define FILTER_MAX_ID_SETS 4   // different sensor_id sets per program
+
+//================================= Columnar Block ==============================//
+/*
+Block of readings in columnar (struct-of-arrays) layout.
+sensor_data_t[] keeps each reading together (array-of-structs), so a range
+check on temperature loads 16 bytes to use 4. Here every field is its own
+array, so one SIMD load checks 4-16 readings at once.
+
+    temperature: [t0 t1 t2 t3 ...]
+    humidity:    [h0 h1 h2 h3 ...]
+    status:      [s0 s1 s2 s3 ...]
+*/
+typedef struct {
+    float temperature[FILTER_BLOCK_SIZE];
+    float humidity[FILTER_BLOCK_SIZE];
+    uint32_t timestamp[FILTER_BLOCK_SIZE];
+    uint8_t sensor_id[FILTER_BLOCK_SIZE];
+    uint8_t status[FILTER_BLOCK_SIZE];
+    size_t count;  // valid readings in this block
+} reading_block_t;
+
+//================================= Program ==============================//
+// Instructions. Predicates push one bitmap, AND/OR pop two and push one, NOT replaces the top.
+typedef enum {
+    FILTER_OP_STATUS_ANY,   // (status & mask) != 0      any of the bits set
+    FILTER_OP_STATUS_ALL,   // (status & mask) == mask   all of the bits set
+    FILTER_OP_STATUS_NONE,  // (status & mask) == 0      none of the bits set
+    FILTER_OP_TEMP_IN,      // lo <= temperature <= hi
+    FILTER_OP_TEMP_OUT,     // temperature outside [lo, hi]
+    FILTER_OP_HUM_IN,       // lo <= humidity <= hi
+    FILTER_OP_HUM_OUT,      // humidity outside [lo, hi]
+    FILTER_OP_ID_IN,        // sensor_id is in id set 'set'
+    FILTER_OP_AND,
+    FILTER_OP_OR,
+    FILTER_OP_NOT
+} filter_opcode_t;
+
+typedef struct {
+    filter_opcode_t op;
+    uint8_t mask;   // status ops
+    uint8_t set;    // ID_IN: index into id_sets
+    float lo, hi;   // range ops
+} filter_instr_t;
+
+/*
+Flat program in postfix order (like an RPN calculator). Example:
+
+    status has TEMP_FAULT or COMM_ERROR  OR  temperature outside [0, 45]
+
+    STATUS_ANY(0x09)  TEMP_OUT(0, 45)  OR
+*/
+typedef struct {
+    filter_instr_t code[FILTER_MAX_INSTR];
+    size_t length;
+    uint64_t id_sets[FILTER_MAX_ID_SETS][4];  // 256-bit membership bitmap per set
+    size_t id_set_count;
+    int depth;         // stack depth after the last instruction (must be 1 to run)
+    bool compiled;     // filter_compile() succeeded
+} filter_program_t;
+
+//================================= Error Codes ==============================//
+typedef enum {
+    FILTER_SUCCESS,        // Operation succeeded
+    FILTER_ERROR_NULL,     // Provided pointer is NULL
+    FILTER_ERROR_FULL,     // Too many instructions or id sets
+    FILTER_ERROR_STACK,    // AND/OR/NOT without enough operands, or stack too deep
+    FILTER_ERROR_INVALID   // Program does not leave exactly one result / not compiled
+} filter_error_t;
+
+//================================= Function Prototypes =======================//
+// Building a program (each call appends one instruction)
+void filter_init(filter_program_t* prog);
+filter_error_t filter_status_any(filter_program_t* prog, uint8_t mask);
+filter_error_t filter_status_all(filter_program_t* prog, uint8_t mask);
+filter_error_t filter_status_none(filter_program_t* prog, uint8_t mask);
+filter_error_t filter_temp_in(filter_program_t* prog, float lo, float hi);
+filter_error_t filter_temp_out(filter_program_t* prog, float lo, float hi);
+filter_error_t filter_hum_in(filter_program_t* prog, float lo, float hi);
+filter_error_t filter_hum_out(filter_program_t* prog, float lo, float hi);
+filter_error_t filter_id_in(filter_program_t* prog, const uint8_t* ids, size_t id_count);
+filter_error_t filter_and(filter_program_t* prog);
+filter_error_t filter_or(filter_program_t* prog);
+filter_error_t filter_not(filter_program_t* prog);
+
+// Check the program (exactly one result on the stack) and mark it runnable
+filter_error_t filter_compile(filter_program_t* prog);
+
+// Convert array-of-structs readings into a columnar block (n <= FILTER_BLOCK_SIZE)
+size_t filter_load_block(reading_block_t* block, const sensor_data_t* readings, size_t n);
+
+// Evaluate the program over one block. Bit i of out_bitmap = reading i selected.
+// Returns the number of selected readings.
+size_t filter_run(const filter_program_t* prog, const reading_block_t* block, uint64_t out_bitmap[FILTER_BITMAP_WORDS]);
+
+// Turn a selection bitmap into a list of reading indices, returns how many
+size_t filter_bitmap_to_indices(const uint64_t bitmap[FILTER_BITMAP_WORDS], uint16_t* out_indices);
+
+#endif // STATUS_FILTER_H
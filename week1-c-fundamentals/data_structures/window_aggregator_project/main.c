@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <math.h>
+#include "window_aggregator.h"
+
+
+// Helper function to force enqueue a reading through the aggregator
+void add_reading_force(window_aggregator_t* agg, float temp, float hum, uint8_t id){
+    sensor_data_t db = create_sensor_data(temp, hum, id);
+    agg_error_t err = agg_enqueue_force(agg, &db);
+    if(err != AGG_SUCCESS){
+        printf("Error enqueueing data, error code: %d\n", err);
+    }
+}
+
+// Recompute mean/min/max the old way (walk the buffer) to check the aggregator.
+// The sliding window is the last N readings of this sensor still in the buffer.
+void check_against_buffer(const window_aggregator_t* agg, uint8_t id){
+    const circular_buffer_t* cb = agg->cb;
+    float temps[BUFFER_SIZE];
+    size_t found = 0;
+
+    size_t index = cb->tail;
+    for(size_t i = 0; i < cb->count; i++){ // oldest to newest
+        if(cb->buffer[index].sensor_id == id) temps[found++] = cb->buffer[index].temperature;
+        index = (index + 1) % cb->capacity;
+    }
+
+    size_t first = (found > agg->window_size) ? found - agg->window_size : 0; // keep the newest N
+    size_t n = found - first;
+    float sum = 0, min = 1e9f, max = -1e9f;
+    for(size_t i = first; i < found; i++){
+        sum += temps[i];
+        if(temps[i] < min) min = temps[i];
+        if(temps[i] > max) max = temps[i];
+    }
+
+    agg_stats_t st;
+    if(agg_get_stats(agg, id, &st) != AGG_SUCCESS){
+        printf("Sensor %u: no stats (buffer walk found %zu readings)\n", id, n);
+        return;
+    }
+    bool ok = (st.count == n) && (fabsf(st.temp_mean - sum / n) < 1e-3f) && (st.temp_min == min) && (st.temp_max == max);
+    printf("Sensor %u check against buffer walk: %s\n", id, ok ? "OK" : "MISMATCH");
+}
+
+
+int main()
+{
+    //============================== SLIDING WINDOW ==============================
+    printf("Sliding window (N = 3 per sensor, buffer holds %d readings):\n\n", BUFFER_SIZE);
+
+    circular_buffer_t cb1;
+    window_aggregator_t agg1;
+    cb_init(&cb1);
+    agg_error_t err = agg_attach(&agg1, &cb1, AGG_MODE_SLIDING, 3);
+    if(err != AGG_SUCCESS){
+        printf("Error attaching aggregator, error code: %d\n", err);
+        return 1;
+    }
+
+    add_reading_force(&agg1, 25.5, 40, 1);
+    add_reading_force(&agg1, 20.0, 70, 2);
+    add_reading_force(&agg1, 27.6, 45, 1);
+    add_reading_force(&agg1, 28.6, 50, 1);
+    add_reading_force(&agg1, 29.6, 55, 1); // sensor 1 window slides: 25.5 drops out
+    agg_print_all(&agg1);
+
+    // Buffer is full: the next force enqueue overwrites the oldest reading (sensor 1, 25.5 already out of window)
+    // and the one after overwrites sensor 2's only reading, which must leave its window too
+    printf("\nAfter two overwrites:\n");
+    add_reading_force(&agg1, 35.7, 65, 1);
+    add_reading_force(&agg1, 21.0, 60, 3);
+    cb_print_all(&cb1);
+    agg_print_all(&agg1);
+    check_against_buffer(&agg1, 1);
+    check_against_buffer(&agg1, 3);
+
+    // Dequeue also removes the reading from its window
+    sensor_data_t out;
+    agg_dequeue(&agg1, &out);
+    printf("\nAfter dequeue of %.2f (sensor %u):\n", out.temperature, out.sensor_id);
+    agg_print_all(&agg1);
+    check_against_buffer(&agg1, 1);
+    printf("------------------------------------------------------------\n");
+
+    //============================== TUMBLING WINDOW ==============================
+    printf("Tumbling window (blocks of 2 per sensor):\n\n");
+
+    circular_buffer_t cb2;
+    window_aggregator_t agg2;
+    cb_init(&cb2);
+    agg_attach(&agg2, &cb2, AGG_MODE_TUMBLING, 2);
+
+    add_reading_force(&agg2, 30.0, 50, 1);
+    agg_print_all(&agg2); // first block not complete yet
+    add_reading_force(&agg2, 32.0, 52, 1);
+    add_reading_force(&agg2, 18.0, 80, 2);
+    add_reading_force(&agg2, 40.0, 10, 1); // starts sensor 1's second block
+    agg_print_all(&agg2);
+    printf("------------------------------------------------------------\n");
+
+    return 0;
+}
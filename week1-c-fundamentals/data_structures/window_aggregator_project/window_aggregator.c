@@ -0,0 +1,287 @@
+// Functions implementation
+
+#include "window_aggregator.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>   // for sqrt
+
+//================================ deque helpers =================================
+// Private helpers for the monotonic min/max deques
+
+static void deque_reset(agg_deque_t* dq){
+    dq->front = 0;
+    dq->size = 0;
+}
+
+// Add a value at the back. 'keep_min' = true for a min-deque, false for a max-deque.
+// Entries at the back that are worse than the new value can never win again -> drop them.
+// Each value is pushed and popped at most once, so this is O(1) amortized.
+static void deque_push(agg_deque_t* dq, uint32_t seq, float value, bool keep_min){
+    while(dq->size > 0){
+        size_t back = (dq->front + dq->size - 1) % AGG_MAX_WINDOW;
+        float v = dq->items[back].value;
+        if(keep_min ? (v < value) : (v > value)) break; // back stays, stop popping
+        dq->size--;
+    }
+    size_t pos = (dq->front + dq->size) % AGG_MAX_WINDOW;
+    dq->items[pos].seq = seq;
+    dq->items[pos].value = value;
+    dq->size++;
+}
+
+// The reading 'seq' left the window: if it is the current min/max, drop it
+static void deque_evict(agg_deque_t* dq, uint32_t seq){
+    if((dq->size > 0) && (dq->items[dq->front].seq == seq)){
+        dq->front = (dq->front + 1) % AGG_MAX_WINDOW;
+        dq->size--;
+    }
+}
+
+static float deque_front(const agg_deque_t* dq){
+    return dq->items[dq->front].value;
+}
+
+//================================ channel helpers ===============================
+
+// Empty the window of a channel (new channel or new tumbling block)
+static void channel_reset_window(agg_channel_t* ch){
+    ch->first = 0;
+    ch->count = 0;
+    ch->temp_sum = ch->temp_sumsq = 0.0;
+    ch->hum_sum = ch->hum_sumsq = 0.0;
+    deque_reset(&ch->temp_min);
+    deque_reset(&ch->temp_max);
+    deque_reset(&ch->hum_min);
+    deque_reset(&ch->hum_max);
+}
+
+// Turn running sums into mean / stddev and read min / max from the deque fronts
+static void channel_compute_stats(const agg_channel_t* ch, agg_stats_t* out){
+    double n = (double)ch->count;
+    double temp_mean = ch->temp_sum / n;
+    double hum_mean = ch->hum_sum / n;
+    double temp_var = ch->temp_sumsq / n - temp_mean * temp_mean;
+    double hum_var = ch->hum_sumsq / n - hum_mean * hum_mean;
+
+    out->count = ch->count;
+    out->temp_mean = (float)temp_mean;
+    out->temp_min = deque_front(&ch->temp_min);
+    out->temp_max = deque_front(&ch->temp_max);
+    out->temp_stddev = (float)sqrt(temp_var > 0.0 ? temp_var : 0.0); // rounding can make it slightly negative
+    out->hum_mean = (float)hum_mean;
+    out->hum_min = deque_front(&ch->hum_min);
+    out->hum_max = deque_front(&ch->hum_max);
+    out->hum_stddev = (float)sqrt(hum_var > 0.0 ? hum_var : 0.0);
+}
+
+// Remove the oldest reading of the channel's window: O(1)
+static void channel_remove_oldest(agg_channel_t* ch){
+    const agg_sample_t* s = &ch->window[ch->first];
+
+    ch->temp_sum -= s->temperature;
+    ch->temp_sumsq -= (double)s->temperature * s->temperature;
+    ch->hum_sum -= s->humidity;
+    ch->hum_sumsq -= (double)s->humidity * s->humidity;
+
+    deque_evict(&ch->temp_min, s->seq);
+    deque_evict(&ch->temp_max, s->seq);
+    deque_evict(&ch->hum_min, s->seq);
+    deque_evict(&ch->hum_max, s->seq);
+
+    ch->first = (ch->first + 1) % AGG_MAX_WINDOW;
+    ch->count--;
+}
+
+// Add a reading to the channel's window: O(1) amortized
+static void channel_add(window_aggregator_t* agg, agg_channel_t* ch, const sensor_data_t* data, uint32_t seq){
+
+    if((agg->mode == AGG_MODE_SLIDING) && (ch->count == agg->window_size)){
+        channel_remove_oldest(ch); // window full: oldest reading slides out
+    }
+
+    agg_sample_t* s = &ch->window[(ch->first + ch->count) % AGG_MAX_WINDOW];
+    s->seq = seq;
+    s->temperature = data->temperature;
+    s->humidity = data->humidity;
+    ch->count++;
+
+    ch->temp_sum += data->temperature;
+    ch->temp_sumsq += (double)data->temperature * data->temperature;
+    ch->hum_sum += data->humidity;
+    ch->hum_sumsq += (double)data->humidity * data->humidity;
+
+    deque_push(&ch->temp_min, seq, data->temperature, true);
+    deque_push(&ch->temp_max, seq, data->temperature, false);
+    deque_push(&ch->hum_min, seq, data->humidity, true);
+    deque_push(&ch->hum_max, seq, data->humidity, false);
+
+    if((agg->mode == AGG_MODE_TUMBLING) && (ch->count == agg->window_size)){
+        channel_compute_stats(ch, &ch->last_window); // block complete: publish it
+        ch->windows_completed++;
+        channel_reset_window(ch);                    // and start the next block
+    }
+}
+
+// Find the channel of a sensor_id, creating it if 'create' is true and there is room
+static agg_channel_t* find_channel(window_aggregator_t* agg, uint8_t sensor_id, bool create){
+    uint8_t index = agg->channel_of[sensor_id];
+    if(index != AGG_NO_CHANNEL) return &agg->channels[index];
+
+    if(!create || (agg->channel_count == AGG_MAX_CHANNELS)) return NULL;
+
+    agg_channel_t* ch = &agg->channels[agg->channel_count];
+    ch->sensor_id = sensor_id;
+    ch->windows_completed = 0;
+    channel_reset_window(ch);
+    agg->channel_of[sensor_id] = (uint8_t)agg->channel_count;
+    agg->channel_count++;
+    return ch;
+}
+
+// A new reading entered the buffer with sequence number 'seq'
+static void aggregate(window_aggregator_t* agg, const sensor_data_t* data, uint32_t seq){
+    agg_channel_t* ch = find_channel(agg, data->sensor_id, true);
+    if(ch == NULL){
+        agg->dropped++; // more sensor_ids than AGG_MAX_CHANNELS
+        return;
+    }
+    channel_add(agg, ch, data, seq);
+}
+
+/*
+The buffer's oldest reading (sequence 'seq') is leaving the buffer, because of
+cb_dequeue or because cb_enqueue_force overwrote it.
+In sliding mode the window only covers readings still in the buffer, so it must
+leave the window too. The buffer is FIFO, so if it is still in its channel's
+window it is that channel's oldest reading. It may already be gone if the
+window (N) is smaller than the buffer.
+Tumbling blocks describe the stream, not the buffer, so they are not touched.
+*/
+static void evict(window_aggregator_t* agg, uint8_t sensor_id, uint32_t seq){
+    if(agg->mode != AGG_MODE_SLIDING) return;
+
+    agg_channel_t* ch = find_channel(agg, sensor_id, false);
+    if((ch != NULL) && (ch->count > 0) && (ch->window[ch->first].seq == seq)){
+        channel_remove_oldest(ch);
+    }
+}
+
+//================================ agg_attach ==============================
+// Initialize the aggregator and attach it to a buffer
+agg_error_t agg_attach(window_aggregator_t* agg, circular_buffer_t* cb, agg_mode_t mode, size_t window_size){
+
+    if((agg == NULL) || (cb == NULL)) return AGG_ERROR_NULL;
+    if((window_size == 0) || (window_size > AGG_MAX_WINDOW)) return AGG_ERROR_INVALID;
+
+    agg->cb = cb;
+    agg->mode = mode;
+    agg->window_size = window_size;
+    agg->next_seq = 0;
+    agg->channel_count = 0;
+    agg->dropped = 0;
+    memset(agg->channel_of, AGG_NO_CHANNEL, sizeof(agg->channel_of));
+
+    // Aggregate what is already in the buffer, from oldest (tail) to newest
+    size_t index = cb->tail;
+    for(size_t i = 0; i < cb->count; i++){
+        aggregate(agg, &cb->buffer[index], agg->next_seq++);
+        index = (index + 1) % cb->capacity;
+    }
+
+    return AGG_SUCCESS;
+}
+
+//================================ agg_enqueue ==============================
+// cb_enqueue + update stats
+agg_error_t agg_enqueue(window_aggregator_t* agg, const sensor_data_t* data){
+
+    if((agg == NULL) || (data == NULL)) return AGG_ERROR_NULL;
+
+    cb_error_t err = cb_enqueue(agg->cb, data);
+    if(err == CB_ERROR_FULL) return AGG_ERROR_FULL;
+    if(err != CB_SUCCESS) return AGG_ERROR_NULL;
+
+    aggregate(agg, data, agg->next_seq++);
+    return AGG_SUCCESS;
+}
+
+//============================ agg_enqueue_force ============================
+// cb_enqueue_force + update stats, removing the overwritten reading first
+agg_error_t agg_enqueue_force(window_aggregator_t* agg, const sensor_data_t* data){
+
+    if((agg == NULL) || (data == NULL)) return AGG_ERROR_NULL;
+
+    circular_buffer_t* cb = agg->cb;
+    if(cb_is_full(cb)){
+        // The oldest reading (at tail) is about to be overwritten.
+        // Sequence numbers in the buffer are next_seq - count ... next_seq - 1.
+        const sensor_data_t* oldest = &cb->buffer[cb->tail];
+        evict(agg, oldest->sensor_id, agg->next_seq - (uint32_t)cb->count);
+    }
+
+    if(cb_enqueue_force(cb, data) != CB_SUCCESS) return AGG_ERROR_NULL;
+
+    aggregate(agg, data, agg->next_seq++);
+    return AGG_SUCCESS;
+}
+
+//================================ agg_dequeue ==============================
+// cb_dequeue + remove the dequeued reading from the sliding window
+agg_error_t agg_dequeue(window_aggregator_t* agg, sensor_data_t* out_item){
+
+    if((agg == NULL) || (out_item == NULL)) return AGG_ERROR_NULL;
+
+    uint32_t seq = agg->next_seq - (uint32_t)agg->cb->count; // sequence of the oldest reading
+
+    cb_error_t err = cb_dequeue(agg->cb, out_item);
+    if(err == CB_ERROR_EMPTY) return AGG_ERROR_EMPTY;
+    if(err != CB_SUCCESS) return AGG_ERROR_NULL;
+
+    evict(agg, out_item->sensor_id, seq);
+    return AGG_SUCCESS;
+}
+
+//================================ agg_get_stats ==============================
+// Copy the stats of one sensor to 'out_stats': O(1), no buffer walk
+agg_error_t agg_get_stats(const window_aggregator_t* agg, uint8_t sensor_id, agg_stats_t* out_stats){
+
+    if((agg == NULL) || (out_stats == NULL)) return AGG_ERROR_NULL;
+
+    uint8_t index = agg->channel_of[sensor_id];
+    if(index == AGG_NO_CHANNEL) return AGG_ERROR_NOT_FOUND;
+
+    const agg_channel_t* ch = &agg->channels[index];
+
+    if(agg->mode == AGG_MODE_TUMBLING){
+        if(ch->windows_completed == 0) return AGG_ERROR_EMPTY; // first block not finished yet
+        *out_stats = ch->last_window;
+        return AGG_SUCCESS;
+    }
+
+    if(ch->count == 0) return AGG_ERROR_EMPTY; // all its readings left the buffer
+    channel_compute_stats(ch, out_stats);
+    return AGG_SUCCESS;
+}
+
+//================================ agg_print_all ==============================
+// Print the stats of every tracked sensor
+void agg_print_all(const window_aggregator_t* agg){
+
+    if((agg == NULL) || (agg->channel_count == 0)){
+        printf("Aggregator has no readings!\n");
+        return;
+    }
+
+    for(size_t i = 0; i < agg->channel_count; i++){
+        agg_stats_t st;
+        uint8_t id = agg->channels[i].sensor_id;
+        if(agg_get_stats(agg, id, &st) != AGG_SUCCESS){
+            printf("Sensor ID: %u | no window available yet\n", id);
+            continue;
+        }
+        printf("Sensor ID: %u | N=%zu | Temp mean %.2f min %.2f max %.2f sd %.2f | Hum mean %.2f%% min %.2f%% max %.2f%% sd %.2f\n",
+               id, st.count,
+               st.temp_mean, st.temp_min, st.temp_max, st.temp_stddev,
+               st.hum_mean, st.hum_min, st.hum_max, st.hum_stddev);
+    }
+}
@@ -0,0 +1,119 @@
+// window_aggregator.h
+// Header file for the streaming window aggregator: struct definitions + function prototypes
+// Keeps rolling mean/min/max/stddev of temperature and humidity per sensor_id,
+// updated in O(1) on every enqueue into an attached circular buffer.
+
+#ifndef WINDOW_AGGREGATOR_H
+#define WINDOW_AGGREGATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "../circular_buffer_project/circular_buffer.h"
+
+// Largest window (number of readings per sensor) the aggregator can track
+#define AGG_MAX_WINDOW 64
+
+// Maximum number of different sensor_ids tracked at the same time
+#define AGG_MAX_CHANNELS 16
+
+// Marker in the id -> channel table for "no channel yet"
+#define AGG_NO_CHANNEL 0xFF
+
+//================================= Modes and Error Codes ==============================//
+typedef enum {
+    AGG_MODE_SLIDING,  // stats over the last N readings still in the buffer, updated on every reading
+    AGG_MODE_TUMBLING  // stats over consecutive, non-overlapping blocks of N readings
+} agg_mode_t;
+
+typedef enum {
+    AGG_SUCCESS,        // Operation succeeded
+    AGG_ERROR_FULL,     // Buffer is full, cannot enqueue (non-force mode)
+    AGG_ERROR_EMPTY,    // Buffer is empty / no completed window yet
+    AGG_ERROR_NULL,     // Provided pointer is NULL
+    AGG_ERROR_INVALID,  // Window size is 0 or larger than AGG_MAX_WINDOW
+    AGG_ERROR_NOT_FOUND // No readings for this sensor_id
+} agg_error_t;
+
+//================================= Struct Definitions ==============================//
+// Result for one sensor: what consumers used to compute by copying the buffer out
+typedef struct {
+    size_t count;            // readings in the window
+    float temp_mean;
+    float temp_min;
+    float temp_max;
+    float temp_stddev;       // population standard deviation
+    float hum_mean;
+    float hum_min;
+    float hum_max;
+    float hum_stddev;
+} agg_stats_t;
+
+// One entry of a monotonic deque: the value and the sequence number of its reading
+typedef struct {
+    uint32_t seq;
+    float value;
+} agg_deque_entry_t;
+
+/*
+Monotonic deque used for O(1) sliding min/max.
+For a min-deque values are increasing from front to back, so the front is
+always the minimum of the window. A new value first pops every entry at the
+back that can never be the minimum again.
+*/
+typedef struct {
+    agg_deque_entry_t items[AGG_MAX_WINDOW];
+    size_t front;  // index of the oldest entry
+    size_t size;   // number of entries
+} agg_deque_t;
+
+// One reading inside a channel's window (needed to subtract it when it leaves)
+typedef struct {
+    uint32_t seq;
+    float temperature;
+    float humidity;
+} agg_sample_t;
+
+// Running state for one sensor_id
+typedef struct {
+    uint8_t sensor_id;
+    agg_sample_t window[AGG_MAX_WINDOW]; // ring of the readings currently in the window
+    size_t first;                        // index of the oldest reading in 'window'
+    size_t count;                        // readings currently in the window
+    double temp_sum, temp_sumsq;         // double: repeated add/subtract in float drifts
+    double hum_sum, hum_sumsq;
+    agg_deque_t temp_min, temp_max;      // sliding mode min/max
+    agg_deque_t hum_min, hum_max;
+    agg_stats_t last_window;             // tumbling mode: last completed block
+    size_t windows_completed;            // tumbling mode: number of completed blocks
+} agg_channel_t;
+
+// Aggregator attached to one circular buffer
+typedef struct {
+    circular_buffer_t* cb;                  // attached buffer
+    agg_mode_t mode;
+    size_t window_size;                     // N
+    uint32_t next_seq;                      // sequence number of the next enqueued reading
+    uint8_t channel_of[256];                // sensor_id -> index in channels[] (dense table)
+    agg_channel_t channels[AGG_MAX_CHANNELS];
+    size_t channel_count;
+    size_t dropped;                         // readings not aggregated because channels[] was full
+} window_aggregator_t;
+
+//================================= Function Prototypes =======================//
+// Attach an aggregator to a buffer. Readings already in the buffer are aggregated.
+agg_error_t agg_attach(window_aggregator_t* agg, circular_buffer_t* cb, agg_mode_t mode, size_t window_size);
+
+// Same as cb_enqueue / cb_enqueue_force / cb_dequeue, but keep the stats up to date.
+// Use these instead of the cb_ functions while the aggregator is attached.
+agg_error_t agg_enqueue(window_aggregator_t* agg, const sensor_data_t* data);
+agg_error_t agg_enqueue_force(window_aggregator_t* agg, const sensor_data_t* data);
+agg_error_t agg_dequeue(window_aggregator_t* agg, sensor_data_t* out_item);
+
+// Sliding: stats of the current window. Tumbling: stats of the last completed block.
+agg_error_t agg_get_stats(const window_aggregator_t* agg, uint8_t sensor_id, agg_stats_t* out_stats);
+
+// Print the stats of every tracked sensor
+void agg_print_all(const window_aggregator_t* agg);
+
+#endif // WINDOW_AGGREGATOR_H
@@ -7,7 +7,13 @@
 //===========================
 
 #include "memory_tools.h"
+#include "../../timing/mono_clock_project/mono_clock.h" // shared monotonic clock
+#include "../../timing/trace_project/trace.h" // TRACE_SCOPE: compiled out unless -DUSE_TRACE
+#ifdef USE_ASYNC_LOG
+#include "../../concurrency/async_log_project/async_log.h" // background writer instead of printf
+#endif
 #include <stdio.h>
+#include <inttypes.h> // for PRIu64
 #include <stdlib.h> // for malloc/free
 
 #define MAX_ALLOCATIONS 50  // maximum number of memory blocks to track
@@ -26,14 +32,13 @@ typedef struct {
     void* ptr;             // pointer to the allocated memory block
     size_t size;           // size of the allocated block in bytes
     const char* name;      // descriptive name for debugging (e.g., "sensor_readings")
-    uint32_t timestamp;    // unique timestamp for order of allocation
+    uint64_t timestamp;    // allocation time in ns (mono_clock), also gives the order of allocation
 } allocation_t;
 
 //========================================
 // Static variables (private to this file)
 //========================================
 static allocation_t allocations[MAX_ALLOCATIONS];   // stores metadata for each allocation
-static int time_counter = 0;                        // Static counter simulating timestamps for each allocation since we dont have a real hardware clock yet
 static size_t allocation_count = 0;                 // number of active allocations
 static size_t total_allocated = 0;                  // total bytes currently allocated
 
@@ -52,7 +57,7 @@ static error_t record_allocations(void* p, const char* allocation_name, size_t s
             allocations[i].ptr = p;
             allocations[i].name = allocation_name;
             allocations[i].size = size;
-            allocations[i].timestamp = time_counter++;
+            allocations[i].timestamp = clk_now_ns();
             allocation_count++;
             return OP_OK;
         }
@@ -81,6 +86,7 @@ Safe Allocation:
 - Updates running total of allocated bytes.
 */
 void* safe_malloc(size_t size, const char* allocation_name) {
+    TRACE_SCOPE(TRACE_MALLOC);
     void* p = malloc(size); // allocate memory
     error_t err;
 
@@ -112,6 +118,7 @@ Safe Free:
   ERROR_INVALID if pointer is not tracked.
 */
 error_t safe_free(void* p) {
+    TRACE_SCOPE(TRACE_FREE);
     if (p == NULL) {
         return ERROR_NULL;
     }
@@ -143,9 +150,27 @@ Report all active allocations (memory leaks):
 - Prints total leaks and total allocated bytes.
 */
 void report_leaks(void) {
-    for (int i = 0; i < MAX_ALLOCATIONS; i++) {
+    int i = 0;
+#ifdef USE_ASYNC_LOG
+    if (alog_is_running()) {
+        // Only raw values are queued; names are expected to be string literals.
+        // If the writer stops part way, the rest is printed below.
+        for (; i < MAX_ALLOCATIONS; i++) {
+            if ((allocations[i].ptr != NULL) &&
+                (alog_leak(allocations[i].ptr, allocations[i].name,
+                           allocations[i].size, allocations[i].timestamp) == ALOG_ERROR_STOPPED)) {
+                break;
+            }
+        }
+        if ((i == MAX_ALLOCATIONS) &&
+            (alog_leak_total(get_allocation_count(), get_total_allocated()) != ALOG_ERROR_STOPPED)) {
+            return;
+        }
+    }
+#endif
+    for (; i < MAX_ALLOCATIONS; i++) {
         if (allocations[i].ptr != NULL) { // still allocated
-            printf("Location: %p\nName: %s\nSize: %zu\nTimestamp: %u\n",
+            printf("Location: %p\nName: %s\nSize: %zu\nTimestamp: %" PRIu64 " ns\n",
                    allocations[i].ptr, allocations[i].name,
                    allocations[i].size, allocations[i].timestamp);
         }
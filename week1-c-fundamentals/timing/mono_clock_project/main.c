@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "mono_clock.h"
+#include "../../data_structures/circular_buffer_project/circular_buffer.h"
+
+#define LATENCY_SAMPLES 100000
+
+
+// Used by qsort to sort latency samples
+static int compare_u64(const void* a, const void* b){
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Enqueue -> dequeue latency through the circular buffer, measured with 64-bit ns.
+// The reading's own 32-bit timestamp is also checked with the compatibility helper.
+static void measure_buffer_latency(void){
+    uint64_t* samples = malloc(LATENCY_SAMPLES * sizeof(uint64_t));
+    if(samples == NULL){
+        printf("Error: latency sample allocation failed\n");
+        return;
+    }
+
+    circular_buffer_t cb;
+    cb_init(&cb);
+    uint64_t ts32_max_ns = 0;
+
+    for(size_t i = 0; i < LATENCY_SAMPLES; i++){
+        sensor_data_t in = create_sensor_data(25.0f, 40.0f, 1); // stamped by create_sensor_data
+        uint64_t enqueued = clk_now_ns();
+        cb_enqueue(&cb, &in);
+
+        sensor_data_t out;
+        cb_dequeue(&cb, &out);
+        samples[i] = clk_now_ns() - enqueued;
+
+        uint64_t since_created = clk_ts32_elapsed_ns(out.timestamp, clk_now_ts32());
+        if(since_created > ts32_max_ns) ts32_max_ns = since_created;
+    }
+
+    qsort(samples, LATENCY_SAMPLES, sizeof(uint64_t), compare_u64);
+    printf("  enqueue->dequeue ns: p50=%llu p99=%llu max=%llu\n",
+           (unsigned long long)samples[LATENCY_SAMPLES / 2],
+           (unsigned long long)samples[LATENCY_SAMPLES * 99 / 100],
+           (unsigned long long)samples[LATENCY_SAMPLES - 1]);
+    printf("  create->dequeue via 32-bit timestamp (us resolution): max=%llu ns\n",
+           (unsigned long long)ts32_max_ns);
+    free(samples);
+}
+
+
+int main()
+{
+    printf("Monotonic clock demo\n\n");
+
+    //============================== MONOTONIC backend ==============================
+    clk_error_t err = clk_init(CLK_BACKEND_MONOTONIC);
+    if(err != CLK_SUCCESS){
+        printf("Error initializing clock, error code: %d\n", err);
+        return 1;
+    }
+    printf("Backend: CLOCK_MONOTONIC\n");
+    printf("  read cost: %.1f ns\n", clk_read_cost_ns());
+    measure_buffer_latency();
+    printf("------------------------------------------------------------\n");
+
+    //============================== TSC backend ==============================
+    err = clk_init(CLK_BACKEND_TSC);
+    if(err == CLK_ERROR_NO_TSC){
+        printf("No invariant TSC on this CPU, staying on CLOCK_MONOTONIC\n");
+    } else if(err != CLK_SUCCESS){
+        printf("Error initializing clock, error code: %d\n", err);
+        return 1;
+    } else {
+        printf("Backend: TSC (ns per tick = %.4f)\n", (double)clk_state.mult / 4294967296.0);
+        printf("  read cost: %.1f ns\n", clk_read_cost_ns());
+        printf("  drift vs CLOCK_MONOTONIC: %lld ns\n",
+               (long long)(clk_now_ns() - clk_monotonic_ns()));
+        measure_buffer_latency();
+    }
+    printf("------------------------------------------------------------\n");
+
+    //============================== 32-bit compatibility ==============================
+    uint32_t before_wrap = 0xFFFFFFF0u;  // 16 us before the 32-bit counter wraps
+    uint32_t after_wrap = 0x00000010u;   // 16 us after
+    printf("32-bit elapsed across wrap: %llu ns (expected 32000)\n",
+           (unsigned long long)clk_ts32_elapsed_ns(before_wrap, after_wrap));
+
+    sensor_data_t reading = create_sensor_data(23.5, 45.0, 1);
+    print_sensor_data(&reading);
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+// mono_clock.c
+//===========================
+// Backend selection and TSC calibration for the shared monotonic clock.
+// The TSC read path itself is inline in mono_clock.h.
+//===========================
+
+#define _POSIX_C_SOURCE 199309L // for clock_gettime / CLOCK_MONOTONIC under -std=c11
+#include <time.h>
+#include "mono_clock.h"
+
+#if CLK_HAVE_TSC
+#include <cpuid.h>   // for __get_cpuid
+#endif
+
+#define CLK_CALIBRATION_NS 10000000ull  // 10 ms calibration window
+#define CLK_COST_SAMPLES 1000000        // reads used to measure the read cost
+
+// Zero-initialized: MONOTONIC backend until clk_init() selects the TSC
+clk_state_t clk_state;
+
+#if CLK_HAVE_TSC
+__extension__ typedef unsigned __int128 clk_u128_t; // GCC/Clang extension, only used for calibration
+#endif
+
+//========================= clk_monotonic_ns =================================
+uint64_t clk_monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+//========================= tsc_is_invariant =================================
+/*
+Private helper: the TSC is only usable as a clock if it ticks at a constant
+rate regardless of frequency scaling and sleep states ("invariant TSC",
+CPUID leaf 0x80000007, EDX bit 8).
+*/
+static bool tsc_is_invariant(void) {
+#if CLK_HAVE_TSC
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(0x80000000u, &eax, &ebx, &ecx, &edx) || (eax < 0x80000007u)) {
+        return false; // extended leaf not supported
+    }
+    __get_cpuid(0x80000007u, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+//========================= clk_init =================================
+/*
+Select the backend:
+- MONOTONIC: nothing to calibrate.
+- TSC: read TSC and CLOCK_MONOTONIC at the start and end of a ~10 ms busy
+  window and derive nanoseconds per tick. Falls back to MONOTONIC and returns
+  CLK_ERROR_NO_TSC if the CPU has no invariant TSC.
+*/
+clk_error_t clk_init(clk_backend_t preferred) {
+    struct timespec probe;
+    if (clock_gettime(CLOCK_MONOTONIC, &probe) != 0) {
+        return CLK_ERROR_SYSTEM;
+    }
+
+    clk_state.backend = CLK_BACKEND_MONOTONIC;
+    if (preferred == CLK_BACKEND_MONOTONIC) {
+        return CLK_SUCCESS;
+    }
+
+    if (!tsc_is_invariant()) {
+        return CLK_ERROR_NO_TSC;
+    }
+
+#if CLK_HAVE_TSC
+    uint64_t ns_start = clk_monotonic_ns();
+    uint64_t tsc_start = __rdtsc();
+    uint64_t ns_end, tsc_end;
+    do {
+        ns_end = clk_monotonic_ns();
+        tsc_end = __rdtsc();
+    } while (ns_end - ns_start < CLK_CALIBRATION_NS);
+
+    uint64_t ticks = tsc_end - tsc_start;
+    if (ticks == 0) {
+        return CLK_ERROR_NO_TSC;
+    }
+
+    // ns per tick in 32.32 fixed point (128-bit so the shift cannot overflow)
+    clk_state.mult = (uint64_t)(((clk_u128_t)(ns_end - ns_start) << 32) / ticks);
+    clk_state.base_tsc = tsc_end;
+    clk_state.base_ns = ns_end;
+    clk_state.backend = CLK_BACKEND_TSC;
+#endif
+    return CLK_SUCCESS;
+}
+
+//========================= clk_backend =================================
+clk_backend_t clk_backend(void) {
+    return clk_state.backend;
+}
+
+//========================= clk_read_cost_ns =================================
+/*
+Time a million back-to-back reads with the current backend.
+Useful to check the "few ns" fast path on a given machine.
+*/
+double clk_read_cost_ns(void) {
+    volatile uint64_t sink = 0; // keep the reads from being optimized away
+    uint64_t start = clk_monotonic_ns();
+    for (int i = 0; i < CLK_COST_SAMPLES; i++) {
+        sink += clk_now_ns();
+    }
+    uint64_t elapsed = clk_monotonic_ns() - start;
+    (void)sink;
+    return (double)elapsed / CLK_COST_SAMPLES;
+}
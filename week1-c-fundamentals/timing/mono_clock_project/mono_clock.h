@@ -0,0 +1,106 @@
+// mono_clock.h
+//===========================
+// Shared monotonic clock: 64-bit nanosecond timestamps for every module.
+// Two backends:
+// - CLOCK_MONOTONIC through clock_gettime (default, works everywhere)
+// - the CPU timestamp counter (TSC), calibrated against CLOCK_MONOTONIC,
+//   when the CPU has an invariant TSC (x86 only)
+// Plus helpers for the older 32-bit 'timestamp' fields (sensor_data_t, node).
+//===========================
+
+#ifndef MONO_CLOCK_H
+#define MONO_CLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>   // for __rdtsc
+#define CLK_HAVE_TSC 1
+#else
+#define CLK_HAVE_TSC 0
+#endif
+
+// The 32-bit timestamp fields count microseconds. They wrap every ~71 minutes,
+// so only use them for intervals shorter than that (see clk_ts32_elapsed_ns).
+#define CLK_TS32_UNIT_NS 1000u
+
+//================================= Backends and Error Codes ==============================//
+typedef enum {
+    CLK_BACKEND_MONOTONIC,  // clock_gettime(CLOCK_MONOTONIC)
+    CLK_BACKEND_TSC         // calibrated rdtsc
+} clk_backend_t;
+
+typedef enum {
+    CLK_SUCCESS,        // Operation succeeded
+    CLK_ERROR_NO_TSC,   // TSC requested but missing or not invariant; MONOTONIC is used instead
+    CLK_ERROR_SYSTEM    // clock_gettime failed
+} clk_error_t;
+
+//================================= Clock State ==============================//
+/*
+Calibration result. It is public only so clk_now_ns() can be inlined into
+callers (a function call would cost more than the read itself).
+Do not modify it; use clk_init().
+
+TSC conversion:  ns = base_ns + ((tsc - base_tsc) * mult) >> 32
+mult is "nanoseconds per tick" in 32.32 fixed point.
+*/
+typedef struct {
+    clk_backend_t backend;
+    uint64_t base_tsc;   // TSC value at calibration
+    uint64_t base_ns;    // CLOCK_MONOTONIC at calibration
+    uint64_t mult;       // ns per tick << 32
+} clk_state_t;
+
+extern clk_state_t clk_state;
+
+//================================= Function Prototypes =======================//
+// Select and calibrate a backend (~10 ms for TSC). Optional: without it the
+// MONOTONIC backend is used. Call once at startup, before any threads.
+clk_error_t clk_init(clk_backend_t preferred);
+
+// Backend currently in use
+clk_backend_t clk_backend(void);
+
+// Measured cost of one clk_now_ns() call, in nanoseconds
+double clk_read_cost_ns(void);
+
+// CLOCK_MONOTONIC in nanoseconds (same time base as the TSC backend).
+// Lives in mono_clock.c so including this header needs no POSIX feature macros.
+uint64_t clk_monotonic_ns(void);
+
+//================================= Fast Path ==============================//
+// Current time in nanoseconds (monotonic, 64-bit: does not wrap for ~584 years)
+static inline uint64_t clk_now_ns(void){
+#if CLK_HAVE_TSC
+    if(clk_state.backend == CLK_BACKEND_TSC){
+        // (delta * mult) >> 32 without a 128-bit type: split both into 32-bit halves.
+        // Only the low x low product is shifted, so the result is exact.
+        uint64_t delta = __rdtsc() - clk_state.base_tsc;
+        uint64_t d_hi = delta >> 32, d_lo = delta & 0xFFFFFFFFu;
+        uint64_t m_hi = clk_state.mult >> 32, m_lo = clk_state.mult & 0xFFFFFFFFu;
+        return clk_state.base_ns + ((d_hi * m_hi) << 32) + d_hi * m_lo + d_lo * m_hi + ((d_lo * m_lo) >> 32);
+    }
+#endif
+    return clk_monotonic_ns();
+}
+
+//================================= 32-bit Compatibility ==============================//
+// Convert a 64-bit ns time to the 32-bit microsecond format (wraps)
+static inline uint32_t clk_to_ts32(uint64_t ns){
+    return (uint32_t)(ns / CLK_TS32_UNIT_NS);
+}
+
+// Current time in the 32-bit microsecond format, for sensor_data_t / node timestamps
+static inline uint32_t clk_now_ts32(void){
+    return clk_to_ts32(clk_now_ns());
+}
+
+// Time from 'from' to 'to' (both 32-bit timestamps) in ns.
+// Unsigned subtraction handles one wrap, so it is correct for intervals < ~71 minutes.
+static inline uint64_t clk_ts32_elapsed_ns(uint32_t from, uint32_t to){
+    return (uint64_t)(uint32_t)(to - from) * CLK_TS32_UNIT_NS;
+}
+
+#endif // MONO_CLOCK_H
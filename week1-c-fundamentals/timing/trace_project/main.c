@@ -0,0 +1,110 @@
+// Build with -DUSE_TRACE to turn the probes on; without it they compile to nothing
+#include <stdio.h>
+#include <pthread.h>
+#include "trace.h"
+#include "../mono_clock_project/mono_clock.h"
+#include "../../data_structures/circular_buffer_project/circular_buffer.h"
+#include "../../data_structures/linked_list_project/linked_list.h"
+#include "../../memory_management/dynamic_memory_project/memory_tools.h"
+
+#define CB_THREADS 4
+#define CB_ROUNDS 200000        // enqueue + dequeue pairs per thread
+#define LIST_NODES 1000
+#define LIST_MISSES 2000        // finds of a timestamp that is not in the list (full walk, no print)
+#define MALLOC_ROUNDS 50000
+#define OVERHEAD_ROUNDS 1000000
+
+
+// Each thread has its own buffer; all of them record into the same probes
+static void* cb_worker(void* arg){
+    (void)arg;
+    circular_buffer_t cb;
+    cb_init(&cb);
+    sensor_data_t in = create_sensor_data(23.5, 45.0, 1);
+    sensor_data_t out;
+
+    for(size_t i = 0; i < CB_ROUNDS; i++){
+        cb_enqueue(&cb, &in);
+        cb_dequeue(&cb, &out);
+    }
+    return NULL;
+}
+
+static void list_workload(void){
+    node* list = NULL;
+    for(size_t i = 0; i < LIST_NODES; i++){
+        add_sensor_reading(&list, 20.0f + (float)(i % 10), 50.0f, (uint8_t)(i % 4));
+    }
+    for(size_t i = 0; i < LIST_MISSES; i++){
+        find_specific_reading(&list, 0); // timestamps are never 0 -> walks the whole list
+    }
+    while(list != NULL){
+        delete_specific_reading(&list, list->timestamp); // always the head: O(1)
+    }
+}
+
+static void malloc_workload(void){
+    for(size_t i = 0; i < MALLOC_ROUNDS; i++){
+        sensor_data_t* p = safe_malloc(sizeof(sensor_data_t), "trace demo");
+        safe_free(p);
+    }
+}
+
+// Cost of one empty scoped timer (two clock reads + one record)
+static double scope_overhead_ns(void){
+    uint64_t start = clk_now_ns();
+    for(size_t i = 0; i < OVERHEAD_ROUNDS; i++){
+        TRACE_SCOPE(TRACE_USER_0);
+        __asm__ __volatile__("" ::: "memory"); // keep the loop
+    }
+    return (double)(clk_now_ns() - start) / OVERHEAD_ROUNDS;
+}
+
+
+int main()
+{
+    clk_init(CLK_BACKEND_TSC); // tracing reads the clock twice per call: use the cheap backend
+#ifdef USE_TRACE
+    printf("Tracing compiled in\n\n");
+#else
+    printf("Tracing compiled out (build with -DUSE_TRACE)\n\n");
+#endif
+    trace_dump_at_exit();
+
+    //============================== Multi-threaded buffer ==============================
+    pthread_t threads[CB_THREADS];
+    for(size_t i = 0; i < CB_THREADS; i++) pthread_create(&threads[i], NULL, cb_worker, NULL);
+    for(size_t i = 0; i < CB_THREADS; i++) pthread_join(threads[i], NULL);
+
+    // Histograms of all threads merged into one (threads have exited, their samples stay)
+    trace_hist_t enq;
+    trace_snapshot(TRACE_CB_ENQUEUE, &enq);
+    printf("cb_enqueue from %d threads: %llu samples, p50 %llu ns, p99 %llu ns\n", CB_THREADS,
+           (unsigned long long)enq.total,
+           (unsigned long long)trace_hist_percentile(&enq, 50.0),
+           (unsigned long long)trace_hist_percentile(&enq, 99.0));
+
+    // Snapshots are plain histograms and can be merged further, e.g. enqueue + dequeue
+    trace_hist_t deq;
+    trace_snapshot(TRACE_CB_DEQUEUE, &deq);
+    trace_hist_merge(&enq, &deq);
+    printf("cb_enqueue + cb_dequeue merged: %llu samples, p99.9 %llu ns\n\n",
+           (unsigned long long)enq.total, (unsigned long long)trace_hist_percentile(&enq, 99.9));
+
+    //============================== List and allocator ==============================
+    list_workload();
+    malloc_workload();
+
+    printf("On-demand dump:\n");
+    trace_dump();
+    printf("------------------------------------------------------------\n");
+
+    //============================== Overhead ==============================
+    trace_reset();
+    printf("Empty TRACE_SCOPE: %.1f ns per scope (clock read cost %.1f ns)\n",
+           scope_overhead_ns(), clk_read_cost_ns());
+    printf("------------------------------------------------------------\n");
+    printf("At exit:\n");
+
+    return 0; // trace_dump() runs again from atexit
+}
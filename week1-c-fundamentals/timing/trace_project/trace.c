@@ -0,0 +1,240 @@
+// trace.c
+//===========================
+// Per-thread histograms (registered on first use from a fixed pool) and the
+// merge / percentile / dump functions. The hot path is trace_record().
+//===========================
+
+#include "trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+_Static_assert(TRACE_BUCKETS == 1024, "bucket layout changed, check trace_bucket_high");
+
+static const char* probe_names[TRACE_PROBE_COUNT] = {
+    "cb_enqueue", "cb_dequeue",
+    "list_insert", "list_find", "list_delete",
+    "safe_malloc", "safe_free",
+    "user_0", "user_1"
+};
+
+//============================ histogram helpers ================================
+
+// Highest value that falls in bucket 'index' (HDR reports this "equivalent" value)
+static uint64_t trace_bucket_high(size_t index){
+    if(index < 2 * TRACE_SUB_COUNT) return index;
+    unsigned shift = (unsigned)(index / TRACE_SUB_COUNT) - 1;
+    uint64_t mantissa = index % TRACE_SUB_COUNT + TRACE_SUB_COUNT;
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void trace_hist_reset(trace_hist_t* h){
+    memset(h, 0, sizeof(*h));
+    h->min_ns = UINT64_MAX;
+}
+
+void trace_hist_record(trace_hist_t* h, uint64_t ns){
+    h->counts[trace_bucket(ns)]++;
+    h->total++;
+    h->sum_ns += ns;
+    if(ns < h->min_ns) h->min_ns = ns;
+    if(ns > h->max_ns) h->max_ns = ns;
+}
+
+// Same bucket layout everywhere, so merging is a plain element-wise add
+void trace_hist_merge(trace_hist_t* into, const trace_hist_t* from){
+    for(size_t i = 0; i < TRACE_BUCKETS; i++) into->counts[i] += from->counts[i];
+    into->total += from->total;
+    into->sum_ns += from->sum_ns;
+    if(from->min_ns < into->min_ns) into->min_ns = from->min_ns;
+    if(from->max_ns > into->max_ns) into->max_ns = from->max_ns;
+}
+
+// Smallest bucket value that at least 'percentile' % of the samples are <= to
+uint64_t trace_hist_percentile(const trace_hist_t* h, double percentile){
+    if(h->total == 0) return 0;
+
+    uint64_t target = (uint64_t)((double)h->total * percentile / 100.0 + 0.999999);
+    if(target == 0) target = 1;
+    if(target > h->total) target = h->total;
+
+    uint64_t seen = 0;
+    for(size_t i = 0; i < TRACE_BUCKETS; i++){
+        seen += h->counts[i];
+        if(seen >= target){
+            uint64_t high = trace_bucket_high(i);
+            return (high < h->max_ns) ? high : h->max_ns; // never report more than the real max
+        }
+    }
+    return h->max_ns;
+}
+
+const char* trace_probe_name(trace_probe_t probe){
+    return ((unsigned)probe < TRACE_PROBE_COUNT) ? probe_names[probe] : "unknown";
+}
+
+#ifdef USE_TRACE
+#include <stdatomic.h>
+#include <stdbool.h>
+
+//============================ per-thread histograms ================================
+/*
+Written only by the owning thread, read by trace_snapshot() from any thread.
+Counters are atomics updated with a relaxed load + store instead of a locked
+read-modify-write: there is a single writer, so no update can be lost, and a
+concurrent reader sees each counter either before or after an update.
+*/
+typedef struct {
+    _Atomic uint64_t counts[TRACE_BUCKETS];
+    _Atomic uint64_t total;
+    _Atomic uint64_t sum_ns;
+    _Atomic uint64_t min_ns;
+    _Atomic uint64_t max_ns;
+} thread_hist_t;
+
+typedef struct {
+    thread_hist_t probes[TRACE_PROBE_COUNT];
+} trace_thread_t;
+
+//========================================
+// Static variables (private to this file)
+//========================================
+static _Atomic(trace_thread_t*) threads[TRACE_MAX_THREADS];
+static _Atomic size_t thread_count = 0;
+static _Atomic uint64_t dropped_no_slot = 0;   // thread found all TRACE_MAX_THREADS slots taken
+static _Atomic uint64_t dropped_no_memory = 0; // thread could not allocate its histograms
+static _Thread_local trace_thread_t* my_thread = NULL;
+static _Thread_local _Atomic uint64_t* my_drop_counter = NULL; // set once registration has failed
+
+static inline void bump(_Atomic uint64_t* counter, uint64_t add){
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + add, memory_order_relaxed);
+}
+
+static void thread_hist_reset(thread_hist_t* h){
+    for(size_t i = 0; i < TRACE_BUCKETS; i++) atomic_store_explicit(&h->counts[i], 0, memory_order_relaxed);
+    atomic_store_explicit(&h->total, 0, memory_order_relaxed);
+    atomic_store_explicit(&h->sum_ns, 0, memory_order_relaxed);
+    atomic_store_explicit(&h->min_ns, UINT64_MAX, memory_order_relaxed);
+    atomic_store_explicit(&h->max_ns, 0, memory_order_relaxed);
+}
+
+//========================= get_thread =================================
+// This thread's histograms, registered on first use. Slots are never freed,
+// so samples of threads that already exited still show up in the results.
+static trace_thread_t* get_thread(void){
+    if(my_thread != NULL) return my_thread;
+    if(my_drop_counter != NULL) return NULL;
+
+    // Allocate before taking a slot, so a failed allocation does not use one up.
+    // aligned_alloc needs a size that is a multiple of the alignment.
+    size_t size = (sizeof(trace_thread_t) + 63) & ~(size_t)63;
+    trace_thread_t* t = aligned_alloc(64, size);
+    if(t == NULL){
+        my_drop_counter = &dropped_no_memory;
+        return NULL;
+    }
+
+    size_t slot = atomic_fetch_add(&thread_count, 1);
+    if(slot >= TRACE_MAX_THREADS){
+        atomic_fetch_sub(&thread_count, 1);
+        free(t);
+        my_drop_counter = &dropped_no_slot;
+        return NULL;
+    }
+    for(size_t p = 0; p < TRACE_PROBE_COUNT; p++) thread_hist_reset(&t->probes[p]);
+
+    atomic_store_explicit(&threads[slot], t, memory_order_release);
+    my_thread = t;
+    return t;
+}
+
+//============================ trace_record ================================
+// Hot path: one bucket index, four counter updates, no locks, no syscalls
+void trace_record(trace_probe_t probe, uint64_t ns){
+    trace_thread_t* t = get_thread();
+    if(t == NULL){
+        atomic_fetch_add_explicit(my_drop_counter, 1, memory_order_relaxed);
+        return;
+    }
+
+    thread_hist_t* h = &t->probes[probe];
+    bump(&h->counts[trace_bucket(ns)], 1);
+    bump(&h->total, 1);
+    bump(&h->sum_ns, ns);
+    if(ns < atomic_load_explicit(&h->min_ns, memory_order_relaxed)) atomic_store_explicit(&h->min_ns, ns, memory_order_relaxed);
+    if(ns > atomic_load_explicit(&h->max_ns, memory_order_relaxed)) atomic_store_explicit(&h->max_ns, ns, memory_order_relaxed);
+}
+
+//============================ trace_snapshot ================================
+void trace_snapshot(trace_probe_t probe, trace_hist_t* out){
+    trace_hist_reset(out);
+    if((unsigned)probe >= TRACE_PROBE_COUNT) return;
+
+    size_t n = atomic_load(&thread_count);
+    for(size_t i = 0; i < n; i++){
+        trace_thread_t* t = atomic_load_explicit(&threads[i], memory_order_acquire);
+        if(t == NULL) continue; // slot taken but not set up (yet)
+
+        thread_hist_t* h = &t->probes[probe];
+        for(size_t b = 0; b < TRACE_BUCKETS; b++){
+            out->counts[b] += atomic_load_explicit(&h->counts[b], memory_order_relaxed);
+        }
+        // 'total' is recomputed from the buckets so percentiles stay consistent
+        // when the owner records while we read
+        out->sum_ns += atomic_load_explicit(&h->sum_ns, memory_order_relaxed);
+        uint64_t lo = atomic_load_explicit(&h->min_ns, memory_order_relaxed);
+        uint64_t hi = atomic_load_explicit(&h->max_ns, memory_order_relaxed);
+        if(lo < out->min_ns) out->min_ns = lo;
+        if(hi > out->max_ns) out->max_ns = hi;
+    }
+    for(size_t b = 0; b < TRACE_BUCKETS; b++) out->total += out->counts[b];
+}
+
+//============================ trace_dump ================================
+void trace_dump(void){
+    printf("Trace latency (ns):\n");
+    printf("  %-12s %10s %8s %8s %8s %8s %10s\n", "probe", "count", "mean", "p50", "p99", "p99.9", "max");
+
+    for(size_t p = 0; p < TRACE_PROBE_COUNT; p++){
+        trace_hist_t h;
+        trace_snapshot((trace_probe_t)p, &h);
+        if(h.total == 0) continue;
+
+        printf("  %-12s %10llu %8.1f %8llu %8llu %8llu %10llu\n", probe_names[p],
+               (unsigned long long)h.total, (double)h.sum_ns / (double)h.total,
+               (unsigned long long)trace_hist_percentile(&h, 50.0),
+               (unsigned long long)trace_hist_percentile(&h, 99.0),
+               (unsigned long long)trace_hist_percentile(&h, 99.9),
+               (unsigned long long)h.max_ns);
+    }
+
+    uint64_t no_slot = atomic_load(&dropped_no_slot);
+    uint64_t no_memory = atomic_load(&dropped_no_memory);
+    if(no_slot > 0) printf("  (%llu samples dropped: more than %d threads)\n", (unsigned long long)no_slot, TRACE_MAX_THREADS);
+    if(no_memory > 0) printf("  (%llu samples dropped: histogram allocation failed)\n", (unsigned long long)no_memory);
+}
+
+void trace_dump_at_exit(void){
+    static bool registered = false;
+    if(!registered){
+        registered = true;
+        atexit(trace_dump);
+    }
+}
+
+void trace_reset(void){
+    size_t n = atomic_load(&thread_count);
+    for(size_t i = 0; i < n; i++){
+        trace_thread_t* t = atomic_load_explicit(&threads[i], memory_order_acquire);
+        if(t == NULL) continue;
+        for(size_t p = 0; p < TRACE_PROBE_COUNT; p++) thread_hist_reset(&t->probes[p]);
+    }
+    atomic_store(&dropped_no_slot, 0);
+    atomic_store(&dropped_no_memory, 0);
+}
+
+uint64_t trace_dropped(void){
+    return atomic_load(&dropped_no_slot) + atomic_load(&dropped_no_memory);
+}
+
+#endif // USE_TRACE
@@ -0,0 +1,124 @@
+// trace.h
+//===========================
+// Hot-path tracing: scoped timers feeding per-thread latency histograms.
+// Compiled in only with -DUSE_TRACE. Without it every macro below expands
+// to nothing, so traced modules need no extra files and pay no cost.
+//
+// Histograms are HDR-style (log-linear): values below 64 ns are counted
+// exactly, above that every power of two is split into 32 buckets, so a
+// reported percentile is at most ~3% above the true value.
+// Each thread writes only its own histograms (no atomics RMW, no locks);
+// readers merge all threads' histograms on demand.
+//===========================
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Traced code paths
+typedef enum {
+    TRACE_CB_ENQUEUE,     // cb_enqueue
+    TRACE_CB_DEQUEUE,     // cb_dequeue
+    TRACE_LIST_INSERT,    // add_sensor_reading
+    TRACE_LIST_FIND,      // find_specific_reading
+    TRACE_LIST_DELETE,    // delete_specific_reading
+    TRACE_MALLOC,         // safe_malloc
+    TRACE_FREE,           // safe_free
+    TRACE_USER_0,         // free for application code
+    TRACE_USER_1,
+    TRACE_PROBE_COUNT
+} trace_probe_t;
+
+#define TRACE_SUB_BITS 5                          // 32 sub-buckets per power of two
+#define TRACE_SUB_COUNT (1u << TRACE_SUB_BITS)
+#define TRACE_MAX_BITS 36                         // values up to 2^36 ns (~68 s); larger ones land in the last bucket
+#define TRACE_BUCKETS ((TRACE_MAX_BITS - TRACE_SUB_BITS + 1) * TRACE_SUB_COUNT) // 1024
+#define TRACE_MAX_THREADS 16                      // threads that can record; samples of later ones are counted in trace_dropped()
+
+//================================= Histogram ==============================//
+// Plain histogram: result of trace_snapshot(), can be merged with others
+typedef struct {
+    uint64_t counts[TRACE_BUCKETS];
+    uint64_t total;     // number of samples
+    uint64_t sum_ns;    // for the mean
+    uint64_t min_ns;
+    uint64_t max_ns;    // exact, not bucketed
+} trace_hist_t;
+
+// Bucket of a value: exact below 2 * TRACE_SUB_COUNT, log-linear above
+static inline size_t trace_bucket(uint64_t ns){
+    if(ns < 2 * TRACE_SUB_COUNT) return (size_t)ns;
+    unsigned msb = 63u - (unsigned)__builtin_clzll(ns);
+    if(msb >= TRACE_MAX_BITS) return TRACE_BUCKETS - 1;
+    unsigned shift = msb - TRACE_SUB_BITS;
+    return (size_t)(shift + 1) * TRACE_SUB_COUNT + (size_t)((ns >> shift) - TRACE_SUB_COUNT);
+}
+
+//================================= Function Prototypes =======================//
+// These work in every build (they are cheap and not on the hot path).
+void trace_hist_reset(trace_hist_t* h);
+void trace_hist_record(trace_hist_t* h, uint64_t ns);
+void trace_hist_merge(trace_hist_t* into, const trace_hist_t* from);
+uint64_t trace_hist_percentile(const trace_hist_t* h, double percentile); // highest value of the bucket, in ns
+const char* trace_probe_name(trace_probe_t probe);
+
+#ifdef USE_TRACE
+#include "../mono_clock_project/mono_clock.h"
+
+// Add one sample to this thread's histogram of 'probe'
+void trace_record(trace_probe_t probe, uint64_t ns);
+
+// Merge every thread's histogram of 'probe' into 'out' (threads may keep recording)
+void trace_snapshot(trace_probe_t probe, trace_hist_t* out);
+
+// Print count / mean / p50 / p99 / p99.9 / max of every probe that has samples
+void trace_dump(void);
+
+// Call trace_dump() at normal program exit
+void trace_dump_at_exit(void);
+
+// Clear all histograms. Only while no other thread is recording.
+void trace_reset(void);
+
+// Samples lost because a thread found no free slot (more than TRACE_MAX_THREADS threads)
+// or could not allocate its histograms; trace_dump() reports the two causes separately
+uint64_t trace_dropped(void);
+
+//================================= Scoped Timer ==============================//
+typedef struct {
+    trace_probe_t probe;
+    uint64_t start_ns;
+} trace_scope_t;
+
+static inline trace_scope_t trace_scope_begin(trace_probe_t probe){
+    trace_scope_t scope = { probe, clk_now_ns() };
+    return scope;
+}
+
+static inline void trace_scope_end(trace_scope_t* scope){
+    trace_record(scope->probe, clk_now_ns() - scope->start_ns);
+}
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+// Time from here to the end of the enclosing block, including every early return
+// (GCC/Clang cleanup attribute). Use clk_init(CLK_BACKEND_TSC) for the cheapest reads.
+#define TRACE_SCOPE(probe) \
+    trace_scope_t TRACE_CONCAT(trace_scope_, __LINE__) __attribute__((cleanup(trace_scope_end), unused)) = trace_scope_begin(probe)
+
+#else // tracing compiled out
+
+#define TRACE_SCOPE(probe) ((void)0)
+#define trace_record(probe, ns) ((void)0)
+#define trace_snapshot(probe, out) ((void)(probe), (void)(*(out) = (trace_hist_t){0})) // empty, no trace.c needed
+#define trace_dump() ((void)0)
+#define trace_dump_at_exit() ((void)0)
+#define trace_reset() ((void)0)
+#define trace_dropped() ((uint64_t)0)
+
+#endif // USE_TRACE
+
+#endif // TRACE_H